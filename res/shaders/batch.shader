@@ -0,0 +1,63 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+layout(location = 3) in float texIndex;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+flat out int v_TexIndex;
+
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+    mat4 u_View;
+    mat4 u_Projection;
+};
+
+void main()
+{
+   gl_Position = u_ViewProjection * position;
+   v_TexCoord = texCoord;
+   v_Color = color;
+   v_TexIndex = int(texIndex);
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Textures[16];
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+flat in int v_TexIndex;
+
+void main()
+{
+    // sampler arrays can only be indexed with constant expressions in 330
+    vec4 texColor;
+    switch (v_TexIndex)
+    {
+        case 0: texColor = texture(u_Textures[0], v_TexCoord); break;
+        case 1: texColor = texture(u_Textures[1], v_TexCoord); break;
+        case 2: texColor = texture(u_Textures[2], v_TexCoord); break;
+        case 3: texColor = texture(u_Textures[3], v_TexCoord); break;
+        case 4: texColor = texture(u_Textures[4], v_TexCoord); break;
+        case 5: texColor = texture(u_Textures[5], v_TexCoord); break;
+        case 6: texColor = texture(u_Textures[6], v_TexCoord); break;
+        case 7: texColor = texture(u_Textures[7], v_TexCoord); break;
+        case 8: texColor = texture(u_Textures[8], v_TexCoord); break;
+        case 9: texColor = texture(u_Textures[9], v_TexCoord); break;
+        case 10: texColor = texture(u_Textures[10], v_TexCoord); break;
+        case 11: texColor = texture(u_Textures[11], v_TexCoord); break;
+        case 12: texColor = texture(u_Textures[12], v_TexCoord); break;
+        case 13: texColor = texture(u_Textures[13], v_TexCoord); break;
+        case 14: texColor = texture(u_Textures[14], v_TexCoord); break;
+        case 15: texColor = texture(u_Textures[15], v_TexCoord); break;
+    }
+    color = texColor * v_Color;
+};
\ No newline at end of file
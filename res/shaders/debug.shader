@@ -0,0 +1,34 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_Projection;
+
+void main()
+{
+   gl_Position = u_Projection * position;
+   v_TexCoord = texCoord;
+   v_Color = color;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+// glyphs are white with coverage in alpha, lines and rects hit a solid cell
+uniform sampler2D u_Font;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+void main()
+{
+    color = texture(u_Font, v_TexCoord) * v_Color;
+};
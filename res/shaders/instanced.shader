@@ -0,0 +1,40 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+// per instance, the mat4 takes up locations 2 through 5
+layout(location = 2) in mat4 model;
+layout(location = 6) in vec4 tint;
+
+out vec2 v_TexCoord;
+out vec4 v_Tint;
+
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+    mat4 u_View;
+    mat4 u_Projection;
+};
+
+void main()
+{
+   gl_Position = u_ViewProjection * model * position;
+   v_TexCoord = texCoord;
+   v_Tint = tint;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Texture;
+
+in vec2 v_TexCoord;
+in vec4 v_Tint;
+
+void main()
+{
+    color = texture(u_Texture, v_TexCoord) * v_Tint;
+};
\ No newline at end of file
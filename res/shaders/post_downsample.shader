@@ -0,0 +1,49 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+// one triangle over the whole target, nothing bound but an empty VAO
+void main()
+{
+   vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+   gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+   v_TexCoord = corner;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Source; // twice the size of the target
+// only the first level cuts off what's too dark to bloom, 0 knee turns it off
+uniform float u_Threshold;
+uniform float u_Knee;
+
+in vec2 v_TexCoord;
+
+vec3 Prefilter(vec3 c)
+{
+    // soft knee, so pixels crossing the threshold fade in instead of popping
+    float brightness = max(c.r, max(c.g, c.b));
+    float soft = clamp(brightness - u_Threshold + u_Knee, 0.0, 2.0 * u_Knee);
+    soft = soft * soft / (4.0 * u_Knee + 1e-4);
+    return c * max(soft, brightness - u_Threshold) / max(brightness, 1e-4);
+}
+
+void main()
+{
+    // the center and four diagonals half a target texel out, each of those a
+    // bilinear average of 4 source texels: a 13 texel footprint in 5 fetches
+    vec2 texel = 1.0 / vec2(textureSize(u_Source, 0));
+    vec3 sum = texture(u_Source, v_TexCoord).rgb * 4.0;
+    sum += texture(u_Source, v_TexCoord + vec2(-texel.x, -texel.y)).rgb;
+    sum += texture(u_Source, v_TexCoord + vec2( texel.x, -texel.y)).rgb;
+    sum += texture(u_Source, v_TexCoord + vec2(-texel.x,  texel.y)).rgb;
+    sum += texture(u_Source, v_TexCoord + vec2( texel.x,  texel.y)).rgb;
+    sum *= 0.125;
+    if (u_Knee > 0.0)
+        sum = Prefilter(sum);
+    color = vec4(sum, 1.0);
+};
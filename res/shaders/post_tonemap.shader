@@ -0,0 +1,37 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+   vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+   gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+   v_TexCoord = corner;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform sampler2D u_Scene; // HDR, at the render scale, filtered up or down
+uniform sampler2D u_Bloom; // black when bloom is off
+uniform float u_BloomIntensity;
+uniform float u_Exposure;
+
+in vec2 v_TexCoord;
+
+// Narkowicz's fit of the ACES filmic curve
+vec3 ACES(vec3 x)
+{
+    return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14),
+        0.0, 1.0);
+}
+
+void main()
+{
+    vec3 hdr = texture(u_Scene, v_TexCoord).rgb
+        + texture(u_Bloom, v_TexCoord).rgb * u_BloomIntensity;
+    color = vec4(ACES(hdr * u_Exposure), 1.0);
+};
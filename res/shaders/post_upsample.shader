@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+   vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+   gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+   v_TexCoord = corner;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+// the level below, half the size of the target; blended on with ONE, ONE so
+// the target keeps what the downsample left in it
+uniform sampler2D u_Source;
+
+in vec2 v_TexCoord;
+
+void main()
+{
+    // 3x3 tent over the smaller level
+    vec2 texel = 1.0 / vec2(textureSize(u_Source, 0));
+    vec3 sum = texture(u_Source, v_TexCoord).rgb * 4.0;
+    sum += texture(u_Source, v_TexCoord + vec2(-texel.x, 0.0)).rgb * 2.0;
+    sum += texture(u_Source, v_TexCoord + vec2( texel.x, 0.0)).rgb * 2.0;
+    sum += texture(u_Source, v_TexCoord + vec2(0.0, -texel.y)).rgb * 2.0;
+    sum += texture(u_Source, v_TexCoord + vec2(0.0,  texel.y)).rgb * 2.0;
+    sum += texture(u_Source, v_TexCoord + vec2(-texel.x, -texel.y)).rgb;
+    sum += texture(u_Source, v_TexCoord + vec2( texel.x, -texel.y)).rgb;
+    sum += texture(u_Source, v_TexCoord + vec2(-texel.x,  texel.y)).rgb;
+    sum += texture(u_Source, v_TexCoord + vec2( texel.x,  texel.y)).rgb;
+    color = vec4(sum / 16.0, 1.0);
+};
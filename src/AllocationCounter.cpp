@@ -0,0 +1,109 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef OGLGAME_COUNT_ALLOCATIONS
+
+namespace
+{
+std::atomic<uint64_t> s_Count = 0;
+std::atomic<uint64_t> s_Bytes = 0;
+
+void Count(size_t size)
+{
+  s_Count.fetch_add(1, std::memory_order_relaxed);
+  s_Bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* AlignedAlloc(size_t size, size_t alignment)
+{
+#ifdef _MSC_VER
+  return _aligned_malloc(size, alignment);
+#else
+  // aligned_alloc wants the size to be a multiple of the alignment
+  return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+}
+
+void AlignedFree(void* memory)
+{
+#ifdef _MSC_VER
+  _aligned_free(memory);
+#else
+  free(memory);
+#endif
+}
+}
+
+bool AllocationCounter::IsCounting() { return true; }
+
+AllocationStats AllocationCounter::Get()
+{
+  return { s_Count.load(std::memory_order_relaxed),
+    s_Bytes.load(std::memory_order_relaxed) };
+}
+
+void* operator new(size_t size)
+{
+  Count(size);
+  if (void* memory = malloc(size ? size : 1)) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  Count(size);
+  return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+  Count(size);
+  if (void* memory = AlignedAlloc(size ? size : 1, (size_t)alignment))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+  AlignedFree(memory);
+}
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+  AlignedFree(memory);
+}
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+  AlignedFree(memory);
+}
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+  AlignedFree(memory);
+}
+
+#else
+
+bool AllocationCounter::IsCounting() { return false; }
+
+AllocationStats AllocationCounter::Get() { return {}; }
+
+#endif
\ No newline at end of file
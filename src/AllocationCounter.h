@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+struct AllocationStats
+{
+  uint64_t Count = 0; // calls to operator new, any thread
+  uint64_t Bytes = 0;
+};
+
+/*
+ * With the OGLGAME_COUNT_ALLOCATIONS CMake option (on by default) the global
+ * operator new/delete are replaced by ones that bump two relaxed atomics on
+ * the way to malloc/free. Totals since startup; diff two of them to see what
+ * a stretch of code allocated. Without the option Get() is always zero.
+ */
+class AllocationCounter
+{
+public:
+  static bool IsCounting();
+  static AllocationStats Get();
+};
\ No newline at end of file
@@ -16,3 +16,61 @@ bool GLLogCall(const char* function, const char* file, int line)
   }
   return true;
 }
+
+#ifdef OGLGAME_GL_ERRORS_DEBUG
+static bool s_DebugCallbackInstalled = false;
+
+static void GLAPIENTRY GLDebugCallback(GLenum source, GLenum type, GLuint id,
+    GLenum severity, GLsizei length, const GLchar* message,
+    const void* userParam)
+{
+  if (severity == GL_DEBUG_SEVERITY_NOTIFICATION) return;
+
+  // output is synchronous, so the last call site is the one that did it
+  const GLCallSite& site = g_GLCallSite;
+  std::cerr << "[OpenGL Debug] (" << id << ") " << message << "\n    at "
+            << site.Function << " " << site.File << ":" << site.Line
+            << std::endl;
+  ASSERT(type != GL_DEBUG_TYPE_ERROR);
+}
+#endif
+
+void GLInitErrorChecking()
+{
+#ifdef OGLGAME_GL_ERRORS_DEBUG
+  if (GLEW_VERSION_4_3 || GLEW_KHR_debug)
+  {
+    GLCall(glEnable(GL_DEBUG_OUTPUT));
+    GLCall(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+    GLCall(glDebugMessageCallback(GLDebugCallback, nullptr));
+    s_DebugCallbackInstalled = true;
+  }
+  else
+    std::cout << "Warning: no KHR_debug, GL errors are only checked per frame"
+              << std::endl;
+#endif
+}
+
+void GLCheckFrame()
+{
+#if defined(OGLGAME_GL_ERRORS_FRAME) || defined(OGLGAME_GL_ERRORS_DEBUG)
+#ifdef OGLGAME_GL_ERRORS_DEBUG
+  // the callback already reported these as they happened
+  if (s_DebugCallbackInstalled)
+  {
+    GLClearError();
+    return;
+  }
+#endif
+  bool ok = true;
+  while (GLenum error = glGetError())
+  {
+    const GLCallSite& site = g_GLCallSite;
+    std::cerr << "[OpenGL Error] (" << error << ") this frame, last call was "
+              << site.Function << " " << site.File << ":" << site.Line
+              << std::endl;
+    ok = false;
+  }
+  ASSERT(ok);
+#endif
+}
@@ -13,10 +13,55 @@
 #define ASSERT(x)                                                              \
   if (!(x)) raise(SIGTRAP);
 
+/*
+ * How GLCall checks for errors is picked with the OGLGAME_GL_ERRORS CMake
+ * option, because two glGetError round-trips per call add up and some drivers
+ * serialize on them:
+ *
+ *   CALL  - clear before and check after every call (the original behavior)
+ *   FRAME - remember the last call site, check once per frame in GLCheckFrame
+ *   DEBUG - KHR_debug callback, reports the call site without any polling
+ *   OFF   - nothing at all, the release default
+ *
+ * Default (no define) is CALL.
+ */
+#if defined(OGLGAME_GL_ERRORS_OFF)
+
+#define GLCall(x) x
+
+#elif defined(OGLGAME_GL_ERRORS_FRAME) || defined(OGLGAME_GL_ERRORS_DEBUG)
+
+#define GLCall(x)                                                              \
+  GLSetCallSite(#x, __FILE__, __LINE__);                                       \
+  x
+
+#else
+
 #define GLCall(x)                                                              \
   GLClearError();                                                              \
   x;                                                                           \
   ASSERT(GLLogCall(#x, __FILE__, __LINE__))
 
+#endif
+
 void GLClearError();
-bool GLLogCall(const char* function, const char* file, int line);
\ No newline at end of file
+bool GLLogCall(const char* function, const char* file, int line);
+
+struct GLCallSite
+{
+  const char* Function;
+  const char* File;
+  int Line;
+};
+
+/* Just three stores, cheap enough to leave in front of every call */
+inline GLCallSite g_GLCallSite = { "", "", 0 };
+inline void GLSetCallSite(const char* function, const char* file, int line)
+{
+  g_GLCallSite = { function, file, line };
+}
+
+/* Once the context is current: installs the debug callback in DEBUG mode */
+void GLInitErrorChecking();
+/* Once per frame: drains glGetError in FRAME mode, no-op otherwise */
+void GLCheckFrame();
\ No newline at end of file
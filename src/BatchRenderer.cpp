@@ -0,0 +1,148 @@
+#include "BatchRenderer.h"
+
+#include <vector>
+
+BatchRenderer::BatchRenderer(Shader& shader)
+    : m_Shader(shader)
+    // two full batches a region, so a frame can flush a few times before
+    // it catches up with what the GPU is still drawing
+    , m_VertexBuffer(2 * MaxVertices * sizeof(BatchVertex))
+    , m_Vertices(nullptr)
+    , m_VertexCursor(nullptr)
+    , m_QuadCount(0)
+    , m_TextureSlots {}
+    , m_TextureSlotCount(0)
+{
+  m_VertexArray.AddBuffer<BatchVertex>(m_VertexBuffer);
+
+  std::vector<unsigned int> indices(MaxIndices);
+  unsigned int offset = 0;
+  for (unsigned int i = 0; i < MaxIndices; i += 6, offset += 4)
+  {
+    indices[i + 0] = offset + 0;
+    indices[i + 1] = offset + 1;
+    indices[i + 2] = offset + 2;
+    indices[i + 3] = offset + 2;
+    indices[i + 4] = offset + 3;
+    indices[i + 5] = offset + 0;
+  }
+  m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), MaxIndices);
+
+  const unsigned char white[] = { 255, 255, 255, 255 };
+  m_WhiteTexture = std::make_unique<Texture>(1, 1, white);
+
+  int samplers[MaxTextureSlots];
+  for (unsigned int i = 0; i < MaxTextureSlots; i++)
+    samplers[i] = i;
+  m_Shader.Bind();
+  m_Shader.SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+
+  m_VertexArray.Unbind();
+}
+
+void BatchRenderer::Begin() { StartBatch(); }
+
+void BatchRenderer::End() { Flush(); }
+
+void BatchRenderer::ResetStats()
+{
+  m_Stats = BatchStats();
+  m_VertexBuffer.ResetStats();
+}
+
+void BatchRenderer::StartBatch()
+{
+  m_Vertices = nullptr;
+  m_VertexCursor = nullptr;
+  m_QuadCount = 0;
+  m_TextureSlots[0] = m_WhiteTexture.get();
+  m_TextureSlotCount = 1;
+}
+
+void BatchRenderer::Flush()
+{
+  if (m_QuadCount == 0) return;
+
+  unsigned int size = (unsigned int)((char*)m_VertexCursor
+                                     - (char*)m_Vertices);
+  unsigned int offset = m_VertexBuffer.Unmap(size);
+
+  for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+    m_TextureSlots[i]->Bind(i);
+
+  m_Shader.Bind();
+  m_VertexArray.Bind();
+  m_IndexBuffer->Bind();
+  GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_QuadCount * 6,
+      m_IndexBuffer->GetType(), nullptr, offset / sizeof(BatchVertex)));
+  m_Stats.DrawCalls++;
+  RenderStats::Get().DrawCalls++;
+
+  StartBatch();
+}
+
+float BatchRenderer::GetTextureSlot(const Texture& texture)
+{
+  for (unsigned int i = 1; i < m_TextureSlotCount; i++)
+    if (m_TextureSlots[i] == &texture) return (float)i;
+
+  // out of slots, draw what we have and start over
+  if (m_TextureSlotCount == MaxTextureSlots) Flush();
+
+  m_TextureSlots[m_TextureSlotCount] = &texture;
+  return (float)m_TextureSlotCount++;
+}
+
+void BatchRenderer::DrawQuad(
+    const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+{
+  PushQuad(position, size, color, 0.0f);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size,
+    const Texture& texture, const glm::vec4& tint /*= glm::vec4(1.0f) */)
+{
+  PushQuad(position, size, tint, GetTextureSlot(texture));
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size,
+    const Texture& texture, const glm::vec2& uvMin, const glm::vec2& uvMax,
+    const glm::vec4& tint /*= glm::vec4(1.0f) */)
+{
+  PushQuad(position, size, tint, GetTextureSlot(texture), uvMin, uvMax);
+}
+
+void BatchRenderer::PushQuad(const glm::vec2& position, const glm::vec2& size,
+    const glm::vec4& color, float texIndex,
+    const glm::vec2& uvMin /*= glm::vec2(0.0f) */,
+    const glm::vec2& uvMax /*= glm::vec2(1.0f) */)
+{
+  if (m_QuadCount == MaxQuads)
+  {
+    // the slot we were just handed is gone after a flush, so ask again
+    bool textured = texIndex != 0.0f;
+    const Texture* texture = m_TextureSlots[(unsigned int)texIndex];
+    Flush();
+    if (textured) texIndex = GetTextureSlot(*texture);
+  }
+  if (!m_Vertices)
+  {
+    m_Vertices = (BatchVertex*)m_VertexBuffer.Map(
+        MaxVertices * sizeof(BatchVertex), sizeof(BatchVertex));
+    m_VertexCursor = m_Vertices;
+  }
+
+  // counter-clockwise from the bottom left, same winding as main.cpp's quad
+  const Unorm8x4 packed(color);
+  m_VertexCursor[0] = { position, uvMin, packed, texIndex };
+  m_VertexCursor[1] = { { position.x + size.x, position.y },
+    { uvMax.x, uvMin.y }, packed, texIndex };
+  m_VertexCursor[2] = { { position.x + size.x, position.y + size.y }, uvMax,
+    packed, texIndex };
+  m_VertexCursor[3] = { { position.x, position.y + size.y },
+    { uvMin.x, uvMax.y }, packed, texIndex };
+  m_VertexCursor += 4;
+
+  m_QuadCount++;
+  m_Stats.QuadCount++;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <array>
+#include <memory>
+
+#include "Assert.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "StreamingVertexBuffer.h"
+#include "VertexArray.h"
+
+/* 24 bytes, the color is a byte per channel since tints never need more */
+struct BatchVertex
+{
+  glm::vec2 Position;
+  glm::vec2 TexCoord;
+  Unorm8x4 Color;
+  float TexIndex;
+};
+
+template <> struct VertexFormat<BatchVertex>
+{
+  static constexpr auto Layout = MakeVertexLayout<BatchVertex>(
+      VERTEX_ATTRIBUTE(BatchVertex, Position),
+      VERTEX_ATTRIBUTE(BatchVertex, TexCoord),
+      VERTEX_ATTRIBUTE(BatchVertex, Color),
+      VERTEX_ATTRIBUTE(BatchVertex, TexIndex));
+};
+
+/* Counters for the current frame, cleared by ResetStats() */
+struct BatchStats
+{
+  unsigned int DrawCalls = 0;
+  unsigned int QuadCount = 0;
+};
+
+/*
+ * Writes quads straight into a StreamingVertexBuffer and draws them with a
+ * single glDrawElementsBaseVertex. The index buffer never changes (every quad
+ * is 0 1 2 2 3 0 shifted by four) so it's generated once up front. A flush
+ * happens when the batch is full, when we run out of texture slots, or on
+ * End().
+ *
+ * Slot 0 is always a 1x1 white texture so untextured quads can go through the
+ * same shader: color * white = color.
+ */
+class BatchRenderer
+{
+public:
+  static const unsigned int MaxQuads = 10000;
+  static const unsigned int MaxVertices = MaxQuads * 4;
+  static const unsigned int MaxIndices = MaxQuads * 6;
+  static const unsigned int MaxTextureSlots = 16; // minimum the spec guarantees
+
+private:
+  Shader& m_Shader;
+  VertexArray m_VertexArray;
+  StreamingVertexBuffer m_VertexBuffer;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  std::unique_ptr<Texture> m_WhiteTexture;
+
+  BatchVertex* m_Vertices; // mapped on the first quad of a batch
+  BatchVertex* m_VertexCursor;
+  unsigned int m_QuadCount;
+
+  std::array<const Texture*, MaxTextureSlots> m_TextureSlots;
+  unsigned int m_TextureSlotCount;
+
+  BatchStats m_Stats;
+
+public:
+  BatchRenderer(Shader& shader);
+
+  /* quads are in world space, the shader reads the Camera block */
+  void Begin();
+  void End();
+
+  void DrawQuad(
+      const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+  void DrawQuad(const glm::vec2& position, const glm::vec2& size,
+      const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f));
+  /* part of a texture, e.g. an AtlasRegion's UVMin/UVMax on its page */
+  void DrawQuad(const glm::vec2& position, const glm::vec2& size,
+      const Texture& texture, const glm::vec2& uvMin, const glm::vec2& uvMax,
+      const glm::vec4& tint = glm::vec4(1.0f));
+
+  inline const BatchStats& GetStats() const { return m_Stats; }
+  inline const StreamingStats& GetStreamingStats() const
+  {
+    return m_VertexBuffer.GetStats();
+  }
+  void ResetStats();
+
+private:
+  void StartBatch();
+  void Flush();
+  float GetTextureSlot(const Texture& texture);
+  void PushQuad(const glm::vec2& position, const glm::vec2& size,
+      const glm::vec4& color, float texIndex,
+      const glm::vec2& uvMin = glm::vec2(0.0f),
+      const glm::vec2& uvMax = glm::vec2(1.0f));
+};
\ No newline at end of file
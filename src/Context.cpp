@@ -0,0 +1,185 @@
+#include "Context.h"
+
+#include "GLState.h"
+
+#ifdef OGLGAME_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+Context::Context(int width, int height, bool headless, bool vsync /*= true */)
+    : m_Window(nullptr)
+    , m_Display(nullptr)
+    , m_Context(nullptr)
+    , m_Framebuffer(0)
+    , m_ColorBuffer(0)
+    , m_DepthBuffer(0)
+    , m_Width(width)
+    , m_Height(height)
+    , m_Headless(headless)
+{
+  std::cout << "Starting System..." << std::endl;
+  if (m_Headless)
+    InitHeadless();
+  else
+    InitWindow(vsync);
+  InitGL();
+  std::cout << "Initialization complete..." << std::endl;
+}
+
+Context::~Context()
+{
+  if (m_Headless)
+  {
+    GLCall(glDeleteFramebuffers(1, &m_Framebuffer));
+    GLCall(glDeleteRenderbuffers(1, &m_ColorBuffer));
+    GLCall(glDeleteRenderbuffers(1, &m_DepthBuffer));
+#ifdef OGLGAME_EGL
+    eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(m_Display, m_Context);
+    eglTerminate(m_Display);
+#endif
+    return;
+  }
+  glfwTerminate();
+}
+
+bool Context::ShouldClose() const
+{
+  return m_Window && glfwWindowShouldClose(m_Window);
+}
+
+void Context::SwapBuffers()
+{
+  GLCheckFrame();
+  if (m_Window)
+  {
+    glfwSwapBuffers(m_Window);
+    glfwPollEvents();
+  }
+  else
+  {
+    GLCall(glFlush()); // nothing to present, just make sure work is queued
+  }
+}
+
+void Context::InitWindow(bool vsync)
+{
+  if (!glfwInit())
+  {
+    std::cout << "Failed to initialize glfw" << std::endl;
+    raise(SIGTRAP);
+  }
+
+  /* specify ogl profile */
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef OGLGAME_GL_ERRORS_DEBUG
+  glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
+  m_Window = glfwCreateWindow(m_Width, m_Height, "OpenGL", nullptr, nullptr);
+  if (!m_Window)
+  {
+    glfwTerminate();
+    std::cout << "Opening window failed." << std::endl;
+    raise(SIGTRAP);
+  }
+
+  glfwMakeContextCurrent(m_Window);
+  glfwSwapInterval(vsync ? 1 : 0);
+}
+
+void Context::InitHeadless()
+{
+#ifdef OGLGAME_EGL
+  // surfaceless platform first, plain default display if Mesa doesn't have it
+  EGLDisplay display = EGL_NO_DISPLAY;
+  auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress(
+      "eglGetPlatformDisplayEXT");
+  if (getPlatformDisplay)
+    display = getPlatformDisplay(
+        EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+  if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+  EGLint major, minor;
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+  {
+    std::cout << "Failed to initialize EGL" << std::endl;
+    raise(SIGTRAP);
+  }
+  eglBindAPI(EGL_OPENGL_API);
+
+  // same profile the window asks glfw for
+  const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 3,
+    EGL_CONTEXT_MINOR_VERSION, 3, EGL_CONTEXT_OPENGL_PROFILE_MASK,
+    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifdef OGLGAME_GL_ERRORS_DEBUG
+    EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+    EGL_NONE };
+  EGLContext context = eglCreateContext(
+      display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+  if (context == EGL_NO_CONTEXT
+      || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+  {
+    std::cout << "Creating surfaceless EGL context failed." << std::endl;
+    raise(SIGTRAP);
+  }
+
+  m_Display = display;
+  m_Context = context;
+#else
+  std::cout << "Built without EGL, headless mode is unavailable" << std::endl;
+  raise(SIGTRAP);
+#endif
+}
+
+void Context::InitGL()
+{
+  glewExperimental = GL_TRUE;
+  GLenum status = glewInit();
+  // GLEW still goes looking for a GLX display after loading the entry points,
+  // which there isn't one of under EGL
+  if (status != GLEW_OK
+      && !(m_Headless && status == GLEW_ERROR_NO_GLX_DISPLAY))
+  {
+    std::cout << "glewInit failed" << std::endl;
+    raise(SIGTRAP);
+  }
+
+  std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+  std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+  GLInitErrorChecking();
+  // let the driver link on its own threads, Shader polls for completion
+  if (GLEW_KHR_parallel_shader_compile)
+  {
+    GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+  }
+
+  if (m_Headless)
+  {
+    GLCall(glGenRenderbuffers(1, &m_ColorBuffer));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer));
+    GLCall(glRenderbufferStorage(
+        GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height));
+    GLCall(glGenRenderbuffers(1, &m_DepthBuffer));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer));
+    GLCall(glRenderbufferStorage(
+        GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height));
+
+    GLCall(glGenFramebuffers(1, &m_Framebuffer));
+    GLState::BindFramebuffer(m_Framebuffer);
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_RENDERBUFFER, m_ColorBuffer));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+        GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthBuffer));
+    ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER)
+           == GL_FRAMEBUFFER_COMPLETE);
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+  }
+
+  // Enable blending for transparency
+  GLState::SetBlend(true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
\ No newline at end of file
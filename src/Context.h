@@ -0,0 +1,44 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "Assert.h"
+
+/*
+ * Owns the GL context. Windowed mode is the old init_graphics_system(): a
+ * GLFW window with vsync. Headless mode makes a surfaceless EGL context
+ * (Mesa llvmpipe on the CI boxes) and renders into an offscreen framebuffer
+ * of the same size, so nothing in the renderer has to know the difference.
+ */
+class Context
+{
+private:
+  GLFWwindow* m_Window;
+  void* m_Display; // EGLDisplay/EGLContext, kept opaque so EGL stays in the
+  void* m_Context; // cpp file
+  unsigned int m_Framebuffer;
+  unsigned int m_ColorBuffer;
+  unsigned int m_DepthBuffer;
+  int m_Width, m_Height;
+  bool m_Headless;
+
+public:
+  Context(int width, int height, bool headless, bool vsync = true);
+  ~Context();
+
+  bool ShouldClose() const;
+  void SwapBuffers();
+
+  inline GLFWwindow* GetWindow() const { return m_Window; }
+  /* what "the screen" is: 0 with a window, the offscreen one headless */
+  inline unsigned int GetFramebuffer() const { return m_Framebuffer; }
+  inline bool IsHeadless() const { return m_Headless; }
+  inline int GetWidth() const { return m_Width; }
+  inline int GetHeight() const { return m_Height; }
+
+private:
+  void InitWindow(bool vsync);
+  void InitHeadless();
+  void InitGL();
+};
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "DebugRenderer.h"
+
+#include <algorithm>
+#include <vector>
+
+/* font8x8_basic (public domain, after the IBM PC BIOS font): a byte per row
+   from the top, bit 0 is the leftmost pixel */
+// clang-format off
+static const unsigned char s_Font[][8] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+  { 0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00 }, // '!'
+  { 0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '"'
+  { 0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00 }, // '#'
+  { 0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00 }, // '$'
+  { 0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00 }, // '%'
+  { 0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00 }, // '&'
+  { 0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '\''
+  { 0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00 }, // '('
+  { 0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00 }, // ')'
+  { 0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00 }, // '*'
+  { 0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00 }, // '+'
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06 }, // ','
+  { 0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00 }, // '-'
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00 }, // '.'
+  { 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00 }, // '/'
+  { 0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00 }, // '0'
+  { 0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00 }, // '1'
+  { 0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00 }, // '2'
+  { 0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00 }, // '3'
+  { 0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00 }, // '4'
+  { 0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00 }, // '5'
+  { 0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00 }, // '6'
+  { 0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00 }, // '7'
+  { 0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00 }, // '8'
+  { 0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00 }, // '9'
+  { 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00 }, // ':'
+  { 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06 }, // ';'
+  { 0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00 }, // '<'
+  { 0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00 }, // '='
+  { 0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00 }, // '>'
+  { 0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00 }, // '?'
+  { 0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00 }, // '@'
+  { 0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00 }, // 'A'
+  { 0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00 }, // 'B'
+  { 0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00 }, // 'C'
+  { 0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00 }, // 'D'
+  { 0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00 }, // 'E'
+  { 0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00 }, // 'F'
+  { 0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00 }, // 'G'
+  { 0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00 }, // 'H'
+  { 0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'I'
+  { 0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00 }, // 'J'
+  { 0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00 }, // 'K'
+  { 0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00 }, // 'L'
+  { 0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00 }, // 'M'
+  { 0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00 }, // 'N'
+  { 0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00 }, // 'O'
+  { 0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00 }, // 'P'
+  { 0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00 }, // 'Q'
+  { 0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00 }, // 'R'
+  { 0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00 }, // 'S'
+  { 0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'T'
+  { 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00 }, // 'U'
+  { 0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00 }, // 'V'
+  { 0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00 }, // 'W'
+  { 0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00 }, // 'X'
+  { 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00 }, // 'Y'
+  { 0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00 }, // 'Z'
+  { 0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00 }, // '['
+  { 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00 }, // '\\'
+  { 0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00 }, // ']'
+  { 0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00 }, // '^'
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF }, // '_'
+  { 0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '`'
+  { 0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00 }, // 'a'
+  { 0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00 }, // 'b'
+  { 0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00 }, // 'c'
+  { 0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00 }, // 'd'
+  { 0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00 }, // 'e'
+  { 0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00 }, // 'f'
+  { 0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F }, // 'g'
+  { 0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00 }, // 'h'
+  { 0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'i'
+  { 0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E }, // 'j'
+  { 0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00 }, // 'k'
+  { 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00 }, // 'l'
+  { 0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00 }, // 'm'
+  { 0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00 }, // 'n'
+  { 0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00 }, // 'o'
+  { 0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F }, // 'p'
+  { 0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78 }, // 'q'
+  { 0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00 }, // 'r'
+  { 0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00 }, // 's'
+  { 0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00 }, // 't'
+  { 0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00 }, // 'u'
+  { 0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00 }, // 'v'
+  { 0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00 }, // 'w'
+  { 0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00 }, // 'x'
+  { 0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F }, // 'y'
+  { 0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00 }, // 'z'
+  { 0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00 }, // '{'
+  { 0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00 }, // '|'
+  { 0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00 }, // '}'
+  { 0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '~'
+};
+// clang-format on
+
+// 16 x 6 cells of 8x8: the 95 glyphs, then a solid one in the last cell
+static const unsigned int s_Columns = 16, s_Rows = 6;
+static const unsigned int s_PageWidth = s_Columns * DebugRenderer::GlyphSize;
+static const unsigned int s_PageHeight = s_Rows * DebugRenderer::GlyphSize;
+static const unsigned int s_SolidCell = s_Columns * s_Rows - 1;
+
+static Unorm16x2 PageUV(unsigned int x, unsigned int y)
+{
+  return Unorm16x2(
+      glm::vec2((float)x / s_PageWidth, (float)y / s_PageHeight));
+}
+
+DebugRenderer::DebugRenderer(Shader& shader)
+    : m_Shader(shader)
+    , m_VertexBuffer(MaxVertices * sizeof(DebugVertex))
+    , m_Vertices(nullptr)
+    , m_VertexCursor(nullptr)
+    , m_QuadCount(0)
+{
+  m_VertexArray.AddBuffer<DebugVertex>(m_VertexBuffer);
+
+  std::vector<unsigned int> indices(MaxIndices);
+  unsigned int offset = 0;
+  for (unsigned int i = 0; i < MaxIndices; i += 6, offset += 4)
+  {
+    indices[i + 0] = offset + 0;
+    indices[i + 1] = offset + 1;
+    indices[i + 2] = offset + 2;
+    indices[i + 3] = offset + 2;
+    indices[i + 4] = offset + 3;
+    indices[i + 5] = offset + 0;
+  }
+  m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), MaxIndices);
+
+  /* Bake the page, white everywhere and the glyph in alpha. Texture rows go
+     bottom up, glyph rows top down. */
+  std::vector<unsigned char> pixels(s_PageWidth * s_PageHeight * 4, 255);
+  for (unsigned int cell = 0; cell < s_Columns * s_Rows; cell++)
+  {
+    const unsigned int left = cell % s_Columns * GlyphSize;
+    const unsigned int bottom = cell / s_Columns * GlyphSize;
+    for (unsigned int row = 0; row < GlyphSize; row++)
+      for (unsigned int column = 0; column < GlyphSize; column++)
+      {
+        const bool set = cell == s_SolidCell
+                         || (cell < m_Glyphs.size()
+                             && s_Font[cell][row] >> column & 1);
+        const unsigned int y = bottom + GlyphSize - 1 - row;
+        pixels[((y * s_PageWidth) + left + column) * 4 + 3] = set ? 255 : 0;
+      }
+    if (cell < m_Glyphs.size())
+      m_Glyphs[cell] = { PageUV(left, bottom),
+        PageUV(left + GlyphSize, bottom),
+        PageUV(left + GlyphSize, bottom + GlyphSize),
+        PageUV(left, bottom + GlyphSize) };
+    else if (cell == s_SolidCell)
+      m_Solid = PageUV(left + GlyphSize / 2, bottom + GlyphSize / 2);
+  }
+  m_Font = std::make_unique<Texture>(s_PageWidth, s_PageHeight, pixels.data());
+  // magnified by whole numbers, and linear would bleed in the next cell
+  GLState::BindTextureForEdit(m_Font->GetRendererID());
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+
+  m_Shader.Bind();
+  m_Shader.SetUniform1i("u_Font", 0);
+
+  m_VertexArray.Unbind();
+}
+
+void DebugRenderer::Begin(const glm::mat4& projection)
+{
+  m_Shader.Bind();
+  m_Shader.SetUniformMat4f("u_Projection", projection);
+  m_Vertices = nullptr;
+  m_VertexCursor = nullptr;
+  m_QuadCount = 0;
+}
+
+void DebugRenderer::End() { Flush(); }
+
+void DebugRenderer::ResetStats()
+{
+  m_Stats = DebugStats();
+  m_VertexBuffer.ResetStats();
+}
+
+void DebugRenderer::Flush()
+{
+  if (m_QuadCount == 0) return;
+
+  unsigned int size = (unsigned int)((char*)m_VertexCursor
+                                     - (char*)m_Vertices);
+  unsigned int offset = m_VertexBuffer.Unmap(size);
+
+  m_Font->Bind(0);
+  GLState::SetBlend(true);
+  m_Shader.Bind();
+  m_VertexArray.Bind();
+  m_IndexBuffer->Bind();
+  GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_QuadCount * 6,
+      m_IndexBuffer->GetType(), nullptr, offset / sizeof(DebugVertex)));
+  m_Stats.DrawCalls++;
+  RenderStats::Get().DrawCalls++;
+
+  m_Vertices = nullptr;
+  m_VertexCursor = nullptr;
+  m_QuadCount = 0;
+}
+
+DebugVertex* DebugRenderer::NextQuad()
+{
+  if (m_QuadCount == MaxQuads) Flush();
+  if (!m_Vertices)
+  {
+    m_Vertices = (DebugVertex*)m_VertexBuffer.Map(
+        MaxVertices * sizeof(DebugVertex), sizeof(DebugVertex));
+    m_VertexCursor = m_Vertices;
+  }
+  DebugVertex* quad = m_VertexCursor;
+  m_VertexCursor += 4;
+  m_QuadCount++;
+  return quad;
+}
+
+void DebugRenderer::DrawText(const glm::vec2& position, std::string_view text,
+    const glm::vec4& color /*= glm::vec4(1.0f) */, float scale /*= 1.0f */)
+{
+  const Unorm8x4 packed(color);
+  const float size = GlyphSize * scale;
+  float x = position.x;
+  float y = position.y - size; // bottom of the first line
+  for (char c : text)
+  {
+    if (c == '\n')
+    {
+      x = position.x;
+      y -= size;
+      continue;
+    }
+    if (c != ' ')
+    {
+      if (c < FirstGlyph || c > LastGlyph) c = '?';
+      const std::array<Unorm16x2, 4>& uv = m_Glyphs[c - FirstGlyph];
+      DebugVertex* quad = NextQuad();
+      quad[0] = { { x, y }, uv[0], packed };
+      quad[1] = { { x + size, y }, uv[1], packed };
+      quad[2] = { { x + size, y + size }, uv[2], packed };
+      quad[3] = { { x, y + size }, uv[3], packed };
+      m_Stats.Glyphs++;
+    }
+    x += size;
+  }
+}
+
+void DebugRenderer::DrawLine(const glm::vec2& from, const glm::vec2& to,
+    const glm::vec4& color, float width /*= 1.0f */)
+{
+  const glm::vec2 direction = to - from;
+  const float length = glm::length(direction);
+  if (length == 0.0f) return;
+  // half the width either side of the line
+  const glm::vec2 side
+      = glm::vec2(-direction.y, direction.x) * (0.5f * width / length);
+
+  const Unorm8x4 packed(color);
+  DebugVertex* quad = NextQuad();
+  quad[0] = { from - side, m_Solid, packed };
+  quad[1] = { to - side, m_Solid, packed };
+  quad[2] = { to + side, m_Solid, packed };
+  quad[3] = { from + side, m_Solid, packed };
+  m_Stats.Shapes++;
+}
+
+void DebugRenderer::DrawRect(const glm::vec2& position, const glm::vec2& size,
+    const glm::vec4& color, float width /*= 1.0f */)
+{
+  const float edge = std::min(width, std::min(size.x, size.y) * 0.5f);
+  const float inner = size.y - 2.0f * edge;
+  FillRect(position, { size.x, edge }, color);
+  FillRect({ position.x, position.y + size.y - edge }, { size.x, edge }, color);
+  FillRect({ position.x, position.y + edge }, { edge, inner }, color);
+  FillRect({ position.x + size.x - edge, position.y + edge }, { edge, inner },
+      color);
+}
+
+void DebugRenderer::FillRect(
+    const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+{
+  const Unorm8x4 packed(color);
+  DebugVertex* quad = NextQuad();
+  quad[0] = { position, m_Solid, packed };
+  quad[1] = { { position.x + size.x, position.y }, m_Solid, packed };
+  quad[2] = { position + size, m_Solid, packed };
+  quad[3] = { { position.x, position.y + size.y }, m_Solid, packed };
+  m_Stats.Shapes++;
+}
+
+glm::vec2 DebugRenderer::MeasureText(
+    std::string_view text, float scale /*= 1.0f */)
+{
+  if (text.empty()) return glm::vec2(0.0f);
+  unsigned int lines = 1, column = 0, widest = 0;
+  for (char c : text)
+  {
+    if (c == '\n')
+    {
+      lines++;
+      column = 0;
+    }
+    else
+      widest = std::max(widest, ++column);
+  }
+  return glm::vec2((float)widest, (float)lines) * (GlyphSize * scale);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <array>
+#include <memory>
+#include <string_view>
+
+#include "Assert.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "StreamingVertexBuffer.h"
+#include "Texture.h"
+#include "VertexArray.h"
+
+/* 16 bytes, UVs only ever point into the 128x48 font page */
+struct DebugVertex
+{
+  glm::vec2 Position;
+  Unorm16x2 TexCoord;
+  Unorm8x4 Color;
+};
+
+template <> struct VertexFormat<DebugVertex>
+{
+  static constexpr auto Layout = MakeVertexLayout<DebugVertex>(
+      VERTEX_ATTRIBUTE(DebugVertex, Position),
+      VERTEX_ATTRIBUTE(DebugVertex, TexCoord),
+      VERTEX_ATTRIBUTE(DebugVertex, Color));
+};
+
+/* Counters for the current frame, cleared by ResetStats() */
+struct DebugStats
+{
+  unsigned int DrawCalls = 0;
+  unsigned int Glyphs = 0;
+  unsigned int Shapes = 0; // lines and rect edges, a quad each
+};
+
+/*
+ * Text and debug geometry without ImGui. Everything is a quad sampling one
+ * texture, the font page: printable ASCII from a built-in 8x8 bitmap font
+ * plus a solid cell that lines and rects sample, so a whole frame of labels,
+ * lines and boxes goes out as a single draw call from a StreamingVertexBuffer
+ * (more only past MaxQuads). The page is baked once in the constructor and
+ * uploaded like any other Texture.
+ *
+ * Positions are in whatever space Begin()'s matrix maps from, y up. Text is
+ * GlyphSize * scale units a character, hanging down from its top left.
+ */
+class DebugRenderer
+{
+public:
+  static const unsigned int MaxQuads = 1 << 17; // 10k labels of a dozen chars
+  static const unsigned int MaxVertices = MaxQuads * 4;
+  static const unsigned int MaxIndices = MaxQuads * 6;
+  static const unsigned int GlyphSize = 8;
+  static const char FirstGlyph = ' ', LastGlyph = '~';
+
+private:
+  Shader& m_Shader;
+  VertexArray m_VertexArray;
+  StreamingVertexBuffer m_VertexBuffer;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  std::unique_ptr<Texture> m_Font;
+  // corners of every glyph's cell, counter-clockwise from the bottom left,
+  // packed once so text never goes through packUnorm2x16
+  std::array<std::array<Unorm16x2, 4>, LastGlyph - FirstGlyph + 1> m_Glyphs;
+  Unorm16x2 m_Solid;
+
+  DebugVertex* m_Vertices; // mapped on the first quad of a batch
+  DebugVertex* m_VertexCursor;
+  unsigned int m_QuadCount;
+
+  DebugStats m_Stats;
+
+public:
+  DebugRenderer(Shader& shader);
+
+  void Begin(const glm::mat4& projection);
+  void End();
+
+  /* '\n' starts a new line, anything outside FirstGlyph..LastGlyph is '?' */
+  void DrawText(const glm::vec2& position, std::string_view text,
+      const glm::vec4& color = glm::vec4(1.0f), float scale = 1.0f);
+  void DrawLine(const glm::vec2& from, const glm::vec2& to,
+      const glm::vec4& color, float width = 1.0f);
+  /* outline, `width` thick on the inside */
+  void DrawRect(const glm::vec2& position, const glm::vec2& size,
+      const glm::vec4& color, float width = 1.0f);
+  void FillRect(
+      const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+
+  /* width of the longest line and height of all of them */
+  static glm::vec2 MeasureText(std::string_view text, float scale = 1.0f);
+
+  inline const DebugStats& GetStats() const { return m_Stats; }
+  inline const StreamingStats& GetStreamingStats() const
+  {
+    return m_VertexBuffer.GetStats();
+  }
+  void ResetStats();
+
+private:
+  void Flush();
+  /* room for one more quad, flushing first if the batch is full */
+  DebugVertex* NextQuad();
+};
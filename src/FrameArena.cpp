@@ -0,0 +1,27 @@
+#include "FrameArena.h"
+
+#include "AllocationCounter.h"
+
+namespace
+{
+LinearAllocator s_Arena(256 * 1024);
+FrameMemoryStats s_LastFrame;
+AllocationStats s_FrameStart;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+  return s_Arena.Allocate(size, alignment);
+}
+
+void FrameArena::Reset()
+{
+  const AllocationStats now = AllocationCounter::Get();
+  s_LastFrame.ArenaBytes = s_Arena.GetUsed();
+  s_LastFrame.HeapAllocations = now.Count - s_FrameStart.Count;
+  s_LastFrame.HeapBytes = now.Bytes - s_FrameStart.Bytes;
+  s_Arena.Reset();
+  s_FrameStart = now;
+}
+
+const FrameMemoryStats& FrameArena::GetLastFrame() { return s_LastFrame; }
\ No newline at end of file
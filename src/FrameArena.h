@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "LinearAllocator.h"
+
+struct FrameMemoryStats
+{
+  size_t ArenaBytes = 0;        // handed out by the arena
+  uint64_t HeapAllocations = 0; // operator new calls, see AllocationCounter
+  uint64_t HeapBytes = 0;
+};
+
+/*
+ * Scratch memory for the GL thread that's good until the end of the frame.
+ * Reset() goes at the very end of the frame loop and takes everything back
+ * at once; it's a LinearAllocator underneath, so after the first few frames
+ * nothing in here goes near the heap. Reset() also takes the heap
+ * allocations made since the last one, which is the number to get to zero.
+ *
+ * Containers can live in it too, as long as they die with the frame:
+ *
+ *   std::vector<Thing, FrameAllocator<Thing>> things;
+ */
+class FrameArena
+{
+public:
+  static void* Allocate(
+      size_t size, size_t alignment = alignof(std::max_align_t));
+
+  template <typename T> static T* NewArray(size_t count)
+  {
+    static_assert(std::is_trivially_destructible_v<T>,
+        "FrameArena never runs destructors");
+    T* items = (T*)Allocate(sizeof(T) * count, alignof(T));
+    for (size_t i = 0; i < count; i++)
+      new (items + i) T();
+    return items;
+  }
+
+  static void Reset();
+
+  /* what the frame before the last Reset() used */
+  static const FrameMemoryStats& GetLastFrame();
+};
+
+/* std allocator over FrameArena, deallocate does nothing */
+template <typename T> struct FrameAllocator
+{
+  using value_type = T;
+
+  FrameAllocator() = default;
+  template <typename U> FrameAllocator(const FrameAllocator<U>&) {}
+
+  T* allocate(size_t count)
+  {
+    return (T*)FrameArena::Allocate(sizeof(T) * count, alignof(T));
+  }
+  void deallocate(T*, size_t) {}
+
+  template <typename U> bool operator==(const FrameAllocator<U>&) const
+  {
+    return true;
+  }
+};
\ No newline at end of file
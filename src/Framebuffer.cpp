@@ -0,0 +1,87 @@
+#include "Framebuffer.h"
+
+static unsigned int InternalFormat(ColorFormat format)
+{
+  switch (format)
+  {
+    case ColorFormat::RGBA8: return GL_RGBA8;
+    case ColorFormat::RGBA16F: return GL_RGBA16F;
+    case ColorFormat::R11G11B10F: return GL_R11F_G11F_B10F;
+  }
+  return GL_RGBA8;
+}
+
+static size_t PixelSize(ColorFormat format)
+{
+  return format == ColorFormat::RGBA16F ? 8 : 4;
+}
+
+Framebuffer::Framebuffer(const FramebufferSpec& spec)
+    : m_RendererID(0)
+    , m_ColorAttachment(0)
+    , m_DepthAttachment(0)
+    , m_Spec(spec)
+{
+  GLCall(glGenTextures(1, &m_ColorAttachment));
+  GLState::BindTextureForEdit(m_ColorAttachment);
+  // linear so a pass can read it at another size, e.g. the upscale from a
+  // lower render resolution
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  // the format/type pair only matters for the (absent) data
+  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, InternalFormat(spec.Color),
+      spec.Width, spec.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+  GLCall(glGenFramebuffers(1, &m_RendererID));
+  GLState::BindFramebuffer(m_RendererID);
+  GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+      GL_TEXTURE_2D, m_ColorAttachment, 0));
+
+  if (spec.Depth)
+  {
+    GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+    GLCall(glRenderbufferStorage(
+        GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, spec.Width, spec.Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+        GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment));
+  }
+  ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+}
+
+Framebuffer::~Framebuffer()
+{
+  GLState::ForgetFramebuffer(m_RendererID);
+  GLCall(glDeleteFramebuffers(1, &m_RendererID));
+  GLState::ForgetTexture(m_ColorAttachment);
+  GLCall(glDeleteTextures(1, &m_ColorAttachment));
+  if (m_DepthAttachment)
+  {
+    GLCall(glDeleteRenderbuffers(1, &m_DepthAttachment));
+  }
+}
+
+void Framebuffer::Bind() const
+{
+  GLState::BindFramebuffer(m_RendererID);
+  GLCall(glViewport(0, 0, m_Spec.Width, m_Spec.Height));
+}
+
+void Framebuffer::BindDefault(unsigned int framebuffer, int width, int height)
+{
+  GLState::BindFramebuffer(framebuffer);
+  GLCall(glViewport(0, 0, width, height));
+}
+
+void Framebuffer::BindColor(unsigned int slot /*= 0 */) const
+{
+  GLState::BindTexture(slot, m_ColorAttachment);
+}
+
+size_t Framebuffer::GetByteSize() const
+{
+  return (size_t)m_Spec.Width * m_Spec.Height
+         * (PixelSize(m_Spec.Color) + (m_Spec.Depth ? 4 : 0));
+}
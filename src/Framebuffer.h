@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Assert.h"
+#include "GLState.h"
+
+/* What a color attachment stores. The float ones are for HDR: RGBA16F for
+   the scene, R11G11B10F (half the bytes, no alpha) for blur chains. */
+enum class ColorFormat : uint32_t
+{
+  RGBA8 = 0,
+  RGBA16F = 1,
+  R11G11B10F = 2,
+};
+
+struct FramebufferSpec
+{
+  int Width = 0, Height = 0;
+  ColorFormat Color = ColorFormat::RGBA8;
+  bool Depth = false; // depth24/stencil8 renderbuffer, never sampled
+
+  bool operator==(const FramebufferSpec&) const = default;
+};
+
+/*
+ * A render target: one color texture that can be sampled afterwards, and
+ * optionally a depth/stencil buffer. Bind() makes it the target and sets the
+ * viewport to cover it; BindDefault() goes back to the screen (which is the
+ * Context's offscreen framebuffer when headless).
+ */
+class Framebuffer
+{
+private:
+  unsigned int m_RendererID;
+  unsigned int m_ColorAttachment; // texture
+  unsigned int m_DepthAttachment; // renderbuffer, 0 without depth
+  FramebufferSpec m_Spec;
+
+public:
+  Framebuffer(const FramebufferSpec& spec);
+  ~Framebuffer();
+
+  Framebuffer(const Framebuffer&) = delete;
+  Framebuffer& operator=(const Framebuffer&) = delete;
+
+  void Bind() const;
+  static void BindDefault(unsigned int framebuffer, int width, int height);
+
+  /* the color attachment as a texture, for the next pass to read */
+  void BindColor(unsigned int slot = 0) const;
+
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+  inline unsigned int GetColorAttachment() const { return m_ColorAttachment; }
+  inline const FramebufferSpec& GetSpec() const { return m_Spec; }
+  inline int GetWidth() const { return m_Spec.Width; }
+  inline int GetHeight() const { return m_Spec.Height; }
+  /* every attachment as the GPU stores it */
+  size_t GetByteSize() const;
+};
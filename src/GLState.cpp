@@ -0,0 +1,214 @@
+#include "GLState.h"
+
+GLState::Cache& GLState::Get()
+{
+  static Cache cache;
+  return cache;
+}
+
+/* Returns true (and updates the cache) when the driver needs to hear about it */
+bool GLState::Changed(unsigned int& cached, unsigned int value)
+{
+  if (cached == value)
+  {
+    RenderStats::Get().StateChangesSkipped++;
+    return false;
+  }
+  cached = value;
+  RenderStats::Get().StateChanges++;
+  return true;
+}
+
+unsigned int GLState::TargetIndex(unsigned int target)
+{
+  switch (target)
+  {
+    case GL_ARRAY_BUFFER: return 0;
+    case GL_UNIFORM_BUFFER: return 1;
+    case GL_PIXEL_UNPACK_BUFFER: return 2;
+    case GL_PIXEL_PACK_BUFFER: return 3;
+    case GL_COPY_READ_BUFFER: return 4;
+    case GL_COPY_WRITE_BUFFER: return 5;
+    case GL_DRAW_INDIRECT_BUFFER: return 6;
+  }
+  ASSERT(false);
+  return 0;
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+  if (Changed(Get().Program, program))
+  {
+    GLCall(glUseProgram(program));
+  }
+}
+
+void GLState::BindVertexArray(unsigned int vao)
+{
+  if (Changed(Get().VertexArray, vao))
+  {
+    GLCall(glBindVertexArray(vao));
+  }
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int buffer)
+{
+  Cache& cache = Get();
+  if (target == GL_ELEMENT_ARRAY_BUFFER)
+  {
+    // an unseen VAO starts out with nothing bound
+    if (cache.VertexArray == Unknown)
+    {
+      RenderStats::Get().StateChanges++;
+      GLCall(glBindBuffer(target, buffer));
+      return;
+    }
+    auto [it, inserted] = cache.ElementBuffers.try_emplace(cache.VertexArray, 0);
+    if (Changed(it->second, buffer))
+    {
+      GLCall(glBindBuffer(target, buffer));
+    }
+    return;
+  }
+
+  if (Changed(cache.Buffers[TargetIndex(target)], buffer))
+  {
+    GLCall(glBindBuffer(target, buffer));
+  }
+}
+
+void GLState::BindBufferBase(
+    unsigned int target, unsigned int index, unsigned int buffer)
+{
+  ASSERT(target == GL_UNIFORM_BUFFER && index < MaxUniformBindings);
+  Cache& cache = Get();
+  if (Changed(cache.UniformBindings[index], buffer))
+  {
+    GLCall(glBindBufferBase(target, index, buffer));
+    cache.Buffers[TargetIndex(target)] = buffer;
+  }
+}
+
+void GLState::BindTexture(unsigned int slot, unsigned int texture)
+{
+  ASSERT(slot < MaxTextureSlots);
+  Cache& cache = Get();
+  if (cache.Textures[slot] == texture)
+  {
+    RenderStats::Get().StateChangesSkipped++;
+    return;
+  }
+  // GL_TEXTUREn is just GL_TEXTURE0 + n
+  if (Changed(cache.ActiveSlot, slot))
+  {
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+  }
+  Changed(cache.Textures[slot], texture);
+  GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+}
+
+void GLState::BindTextureForEdit(unsigned int texture)
+{
+  Cache& cache = Get();
+  if (Changed(cache.ActiveSlot, 0))
+  {
+    GLCall(glActiveTexture(GL_TEXTURE0));
+  }
+  if (Changed(cache.Textures[0], texture))
+  {
+    GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+  }
+}
+
+void GLState::BindFramebuffer(unsigned int framebuffer)
+{
+  if (Changed(Get().Framebuffer, framebuffer))
+  {
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer));
+  }
+}
+
+void GLState::SetBlend(bool enabled, unsigned int src /*= GL_SRC_ALPHA */,
+    unsigned int dst /*= GL_ONE_MINUS_SRC_ALPHA */)
+{
+  Cache& cache = Get();
+  if (Changed(cache.BlendEnabled, enabled ? GL_TRUE : GL_FALSE))
+  {
+    if (enabled)
+    {
+      GLCall(glEnable(GL_BLEND));
+    }
+    else
+    {
+      GLCall(glDisable(GL_BLEND));
+    }
+  }
+  if (!enabled) return;
+
+  if (cache.BlendSrc == src && cache.BlendDst == dst)
+  {
+    RenderStats::Get().StateChangesSkipped++;
+    return;
+  }
+  cache.BlendSrc = src;
+  cache.BlendDst = dst;
+  RenderStats::Get().StateChanges++;
+  GLCall(glBlendFunc(src, dst));
+}
+
+void GLState::ForgetProgram(unsigned int program)
+{
+  // a deleted program stays in use until something else is, so just make
+  // sure the next UseProgram goes through
+  if (Get().Program == program) Get().Program = Unknown;
+}
+
+void GLState::ForgetVertexArray(unsigned int vao)
+{
+  Cache& cache = Get();
+  cache.ElementBuffers.erase(vao);
+  if (cache.VertexArray == vao) cache.VertexArray = 0;
+}
+
+void GLState::ForgetBuffer(unsigned int buffer)
+{
+  // glDeleteBuffers unbinds it from every target it's bound to
+  Cache& cache = Get();
+  for (unsigned int& bound : cache.Buffers)
+    if (bound == buffer) bound = 0;
+  for (unsigned int& bound : cache.UniformBindings)
+    if (bound == buffer) bound = 0;
+  for (auto& [vao, bound] : cache.ElementBuffers)
+    if (bound == buffer) bound = 0;
+}
+
+void GLState::ForgetTexture(unsigned int texture)
+{
+  for (unsigned int& bound : Get().Textures)
+    if (bound == texture) bound = 0;
+}
+
+void GLState::ForgetFramebuffer(unsigned int framebuffer)
+{
+  // deleting the bound one falls back to the default framebuffer
+  if (Get().Framebuffer == framebuffer) Get().Framebuffer = 0;
+}
+
+void GLState::Invalidate()
+{
+  Cache& cache = Get();
+  cache.Program = Unknown;
+  cache.VertexArray = Unknown;
+  for (unsigned int& bound : cache.Buffers)
+    bound = Unknown;
+  for (unsigned int& bound : cache.UniformBindings)
+    bound = Unknown;
+  for (auto& [vao, bound] : cache.ElementBuffers)
+    bound = Unknown;
+  cache.ActiveSlot = Unknown;
+  for (unsigned int& bound : cache.Textures)
+    bound = Unknown;
+  cache.Framebuffer = Unknown;
+  cache.BlendEnabled = Unknown;
+  cache.BlendSrc = cache.BlendDst = Unknown;
+}
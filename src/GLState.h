@@ -0,0 +1,72 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Assert.h"
+#include "RenderStats.h"
+
+/*
+ * Shadow copy of the GL binding state. Everything that binds goes through
+ * here, and a bind to whatever is already bound never reaches the driver.
+ * Issued and skipped changes are counted in RenderStats.
+ *
+ * Two things to keep in mind:
+ *  - GL_ELEMENT_ARRAY_BUFFER is part of the VAO, so it's tracked per VAO.
+ *  - Anything that touches GL behind our back (ImGui's renderer, say) has to
+ *    be followed by Invalidate(), which just forgets everything.
+ */
+class GLState
+{
+public:
+  static const unsigned int MaxTextureSlots = 32;
+  static const unsigned int MaxUniformBindings = 16;
+
+  static void UseProgram(unsigned int program);
+  static void BindVertexArray(unsigned int vao);
+  static void BindBuffer(unsigned int target, unsigned int buffer);
+  /* GL_UNIFORM_BUFFER only, also moves the generic binding like GL does */
+  static void BindBufferBase(
+      unsigned int target, unsigned int index, unsigned int buffer);
+  /* for drawing: a texture already on `slot` is left alone, and so is
+     whichever unit happens to be active */
+  static void BindTexture(unsigned int slot, unsigned int texture);
+  /* for glTex* calls, which go to the active unit: binds on slot 0 and
+     always makes that the active one */
+  static void BindTextureForEdit(unsigned int texture);
+  /* GL_FRAMEBUFFER, draw and read together */
+  static void BindFramebuffer(unsigned int framebuffer);
+  static void SetBlend(bool enabled, unsigned int src = GL_SRC_ALPHA,
+      unsigned int dst = GL_ONE_MINUS_SRC_ALPHA);
+
+  /* call before glDelete* so a recycled name isn't mistaken as bound */
+  static void ForgetProgram(unsigned int program);
+  static void ForgetVertexArray(unsigned int vao);
+  static void ForgetBuffer(unsigned int buffer);
+  static void ForgetTexture(unsigned int texture);
+  static void ForgetFramebuffer(unsigned int framebuffer);
+
+  static void Invalidate();
+
+private:
+  static const unsigned int Unknown = ~0u;
+  static const unsigned int BufferTargets = 7;
+
+  struct Cache
+  {
+    unsigned int Program = 0;
+    unsigned int VertexArray = 0;
+    unsigned int Buffers[BufferTargets] = {};
+    unsigned int UniformBindings[MaxUniformBindings] = {};
+    // GL_ELEMENT_ARRAY_BUFFER binding of each VAO we've seen
+    std::unordered_map<unsigned int, unsigned int> ElementBuffers;
+    unsigned int ActiveSlot = 0;
+    unsigned int Textures[MaxTextureSlots] = {};
+    unsigned int Framebuffer = 0;
+    unsigned int BlendEnabled = 0; // GL_FALSE/GL_TRUE, Unknown after reset
+    unsigned int BlendSrc = GL_ONE, BlendDst = GL_ZERO;
+  };
+
+  static Cache& Get();
+  static unsigned int TargetIndex(unsigned int target);
+  static bool Changed(unsigned int& cached, unsigned int value);
+};
\ No newline at end of file
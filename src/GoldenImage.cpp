@@ -0,0 +1,85 @@
+#include "GoldenImage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+static const uint32_t GoldenMagic = 0x474c474f; // "OGLG"
+static const uint32_t GoldenVersion = 1;
+
+struct GoldenFileHeader
+{
+  uint32_t Magic, Version, Width, Height, DrawCalls, StateChanges;
+};
+
+bool GoldenImage::Read(const std::string& filepath, GoldenImage& image)
+{
+  std::ifstream in(filepath, std::ios::binary);
+  GoldenFileHeader header;
+  if (!in.read((char*)&header, sizeof(header))) return false;
+  if (header.Magic != GoldenMagic || header.Version != GoldenVersion
+      || header.Width > 16384 || header.Height > 16384)
+    return false;
+
+  image.Width = (int)header.Width;
+  image.Height = (int)header.Height;
+  image.DrawCalls = header.DrawCalls;
+  image.StateChanges = header.StateChanges;
+  image.Pixels.resize((size_t)header.Width * header.Height * 4);
+  return (bool)in.read((char*)image.Pixels.data(), image.Pixels.size());
+}
+
+bool GoldenImage::Write(const std::string& filepath, const GoldenImage& image)
+{
+  if (image.Pixels.size() != (size_t)image.Width * image.Height * 4)
+    return false;
+  GoldenFileHeader header = { GoldenMagic, GoldenVersion,
+    (uint32_t)image.Width, (uint32_t)image.Height, image.DrawCalls,
+    image.StateChanges };
+  std::ofstream out(filepath, std::ios::binary);
+  if (!out) return false;
+  out.write((const char*)&header, sizeof(header));
+  out.write((const char*)image.Pixels.data(), image.Pixels.size());
+  return (bool)out;
+}
+
+GoldenDiff GoldenImage::Compare(const GoldenImage& expected,
+    const GoldenImage& actual, const GoldenTolerance& tolerance)
+{
+  GoldenDiff diff;
+  if (expected.Width != actual.Width || expected.Height != actual.Height
+      || expected.Pixels.size() != actual.Pixels.size())
+  {
+    diff.SizeMatches = false;
+    return diff;
+  }
+
+  double squares = 0.0;
+  for (size_t p = 0; p < expected.Pixels.size(); p += 4)
+  {
+    unsigned int worst = 0;
+    for (size_t c = p; c < p + 4; c++)
+    {
+      const unsigned int error
+          = (unsigned int)std::abs((int)expected.Pixels[c] - actual.Pixels[c]);
+      worst = std::max(worst, error);
+      squares += (double)error * error;
+    }
+    diff.MaxError = std::max(diff.MaxError, worst);
+    if (worst > tolerance.ChannelError) diff.BadPixels++;
+  }
+  const size_t pixels = expected.Pixels.size() / 4;
+  if (pixels)
+  {
+    diff.BadFraction = (double)diff.BadPixels / pixels;
+    diff.RmsError = std::sqrt(squares / expected.Pixels.size());
+  }
+  return diff;
+}
+
+bool GoldenImage::Passes(
+    const GoldenDiff& diff, const GoldenTolerance& tolerance)
+{
+  return diff.SizeMatches && diff.BadFraction <= tolerance.MaxBadFraction;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* How far off a render may be before it counts as different. Software
+   rasterizers still differ a little between versions in how they round
+   edges and blend, hence a per channel slack and a few stray pixels. */
+struct GoldenTolerance
+{
+  unsigned int ChannelError = 8;        // out of 255, past it is "bad"
+  double MaxBadFraction = 0.001;        // of all pixels
+  unsigned int MaxDrawCallsOver = 0;    // over the golden's count
+  unsigned int MaxStateChangesOver = 0; // same
+};
+
+struct GoldenDiff
+{
+  bool SizeMatches = true;
+  unsigned int MaxError = 0; // worst channel anywhere
+  uint64_t BadPixels = 0;    // any channel past ChannelError
+  double BadFraction = 0.0;
+  double RmsError = 0.0; // over every channel, in 0..255
+};
+
+/*
+ * A reference render and what it cost, for bench --golden: RGBA8 pixels
+ * bottom up the way glReadPixels gives them, plus the draw calls and state
+ * changes the frame took, so a change that draws the same picture with more
+ * work fails like one that draws a different picture.
+ *
+ *   "OGLG" version width height drawCalls stateChanges
+ *   pixels, width * height * 4 bytes
+ */
+struct GoldenImage
+{
+  int Width = 0, Height = 0;
+  uint32_t DrawCalls = 0;
+  uint32_t StateChanges = 0;
+  std::vector<unsigned char> Pixels;
+
+  /* false if `filepath` is missing or anything but a golden */
+  static bool Read(const std::string& filepath, GoldenImage& image);
+  static bool Write(const std::string& filepath, const GoldenImage& image);
+
+  static GoldenDiff Compare(const GoldenImage& expected,
+      const GoldenImage& actual, const GoldenTolerance& tolerance);
+  /* pixels only, the counts are compared by whoever has the tolerance */
+  static bool Passes(const GoldenDiff& diff, const GoldenTolerance& tolerance);
+};
@@ -2,23 +2,39 @@
 
 // what is this
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
+    : IndexBuffer(data, count, sizeof(unsigned int))
+{
+}
+
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count)
+    : IndexBuffer(data, count, sizeof(unsigned short))
+{
+}
+
+IndexBuffer::IndexBuffer(
+    const void* data, unsigned int count, unsigned int indexSize)
     : m_Count(count)
+    , m_Type(indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT)
 {
-  ASSERT(sizeof(unsigned int) == sizeof(GLuint));
+  ASSERT(indexSize == sizeof(GLushort) || indexSize == sizeof(GLuint));
   GLCall(glGenBuffers(1, &m_RendererID));
-  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-  GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int),
-      data, GL_STATIC_DRAW));
+  Bind(); // careful, this lands in whatever VAO is bound
+  GLCall(glBufferData(
+      GL_ELEMENT_ARRAY_BUFFER, count * indexSize, data, GL_STATIC_DRAW));
 }
 
-IndexBuffer::~IndexBuffer() { GLCall(glDeleteBuffers(1, &m_RendererID)); }
+IndexBuffer::~IndexBuffer()
+{
+  GLState::ForgetBuffer(m_RendererID);
+  GLCall(glDeleteBuffers(1, &m_RendererID));
+}
 
 void IndexBuffer::Bind() const
 {
-  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+  GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const // what is this
 {
-  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+  GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
@@ -1,19 +1,27 @@
 #pragma once
 
 #include "Assert.h"
+#include "GLState.h"
 
+/* Indices are 16 or 32 bit; draws read the type off the buffer, so a mesh
+   that fits 16 bits goes through the same calls at half the bandwidth. */
 class IndexBuffer
 {
 private:
   unsigned int m_RendererID;
   unsigned int m_Count;
+  unsigned int m_Type; // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
 
 public:
   IndexBuffer(const unsigned int* data, unsigned int count);
+  IndexBuffer(const unsigned short* data, unsigned int count);
+  /* `indexSize` bytes each, 2 or 4, e.g. straight out of a MeshFile */
+  IndexBuffer(const void* data, unsigned int count, unsigned int indexSize);
   ~IndexBuffer();
 
   void Bind() const;
   void Unbind() const;
 
   inline unsigned int GetCount() const { return m_Count; }
+  inline unsigned int GetType() const { return m_Type; }
 };
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "LatencyMeter.h"
+
+#include <algorithm>
+
+LatencyMeter::LatencyMeter()
+    : m_Pending {}
+    , m_PendingCount(0)
+    , m_TotalMs(0.0)
+{
+}
+
+LatencyMeter::~LatencyMeter()
+{
+  for (unsigned int i = 0; i < m_PendingCount; i++)
+  {
+    GLCall(glDeleteSync(m_Pending[i].Fence));
+  }
+}
+
+void LatencyMeter::Present(Clock::time_point input)
+{
+  if (m_PendingCount == MaxInFlight)
+  {
+    m_Stats.Dropped++;
+    return;
+  }
+  GLCall(GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  // flush now so the fence is on its way without anyone waiting on it
+  GLCall(glFlush());
+  m_Pending[m_PendingCount++] = { fence, input };
+}
+
+void LatencyMeter::Poll()
+{
+  // fences signal in order, so stop at the first one that hasn't
+  unsigned int done = 0;
+  for (; done < m_PendingCount; done++)
+  {
+    const Pending& pending = m_Pending[done];
+    GLCall(GLenum status = glClientWaitSync(pending.Fence, 0, 0));
+    if (status == GL_TIMEOUT_EXPIRED) break;
+    ASSERT(status != GL_WAIT_FAILED);
+
+    const double ms = std::chrono::duration<double, std::milli>(
+        Clock::now() - pending.Input)
+                          .count();
+    GLCall(glDeleteSync(pending.Fence));
+    m_Stats.LastMs = ms;
+    m_Stats.MaxMs = std::max(m_Stats.MaxMs, ms);
+    m_TotalMs += ms;
+    m_Stats.MeanMs = m_TotalMs / ++m_Stats.Samples;
+  }
+  std::move(m_Pending.begin() + done, m_Pending.begin() + m_PendingCount,
+      m_Pending.begin());
+  m_PendingCount -= done;
+}
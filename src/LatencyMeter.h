@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "Assert.h"
+
+struct LatencyStats
+{
+  unsigned int Samples = 0;
+  unsigned int Dropped = 0; // inputs that came faster than we could track
+  double LastMs = 0.0;
+  double MeanMs = 0.0;
+  double MaxMs = 0.0;
+};
+
+/*
+ * Input-to-photon latency, as near as we can get without a camera: from the
+ * moment an input was read to the moment the GPU finished the first frame
+ * that shows it. Present() goes right after the swap of that frame and drops
+ * a fence behind it; Poll() once a frame picks up the fences that have
+ * signaled, without waiting on any, so a sample can read up to a frame long.
+ * Scan-out is still to come after that, add up to a refresh for the real
+ * thing.
+ *
+ * GL thread only.
+ */
+class LatencyMeter
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  static const unsigned int MaxInFlight = 8;
+
+private:
+  struct Pending
+  {
+    GLsync Fence;
+    Clock::time_point Input;
+  };
+
+  std::array<Pending, MaxInFlight> m_Pending;
+  unsigned int m_PendingCount;
+  LatencyStats m_Stats;
+  double m_TotalMs;
+
+public:
+  LatencyMeter();
+  ~LatencyMeter();
+
+  void Present(Clock::time_point input);
+  void Poll();
+
+  inline const LatencyStats& GetStats() const { return m_Stats; }
+};
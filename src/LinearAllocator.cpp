@@ -0,0 +1,55 @@
+#include "LinearAllocator.h"
+
+#include <algorithm>
+#include <cstdint>
+
+LinearAllocator::LinearAllocator(size_t blockSize /*= 64 * 1024 */)
+    : m_BlockSize(blockSize)
+    , m_Block(0)
+    , m_Offset(0)
+    , m_Used(0)
+{
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+  while (true)
+  {
+    if (m_Block < m_Blocks.size())
+    {
+      Block& block = m_Blocks[m_Block];
+      // align the address, not the offset, the block is only new[]-aligned
+      uintptr_t base = (uintptr_t)block.Memory.get();
+      uintptr_t start = (base + m_Offset + alignment - 1) & ~(alignment - 1);
+      if (start + size <= base + block.Size)
+      {
+        m_Offset = start + size - base;
+        m_Used += size;
+        return (void*)start;
+      }
+      // doesn't fit, try the next block (the rest of this one is wasted)
+      m_Block++;
+      m_Offset = 0;
+      continue;
+    }
+
+    // out of blocks, anything bigger than a block gets one to itself
+    size_t blockSize = std::max(m_BlockSize, size + alignment);
+    m_Blocks.push_back({ std::make_unique<char[]>(blockSize), blockSize });
+  }
+}
+
+void LinearAllocator::Reset()
+{
+  m_Block = 0;
+  m_Offset = 0;
+  m_Used = 0;
+}
+
+size_t LinearAllocator::GetCapacity() const
+{
+  size_t capacity = 0;
+  for (const Block& block : m_Blocks)
+    capacity += block.Size;
+  return capacity;
+}
\ No newline at end of file
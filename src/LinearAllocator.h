@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Bump allocator for things that all die at the same time (a frame's worth of
+ * render commands, say). Allocate() moves a pointer forward, Reset() moves it
+ * back to the start; nothing is freed one at a time and nothing gets
+ * destructed, so only trivially destructible types go in here.
+ *
+ * Memory comes in blocks that are kept across Reset(), so after the first
+ * few frames it never touches the heap again. One per thread, it doesn't
+ * lock.
+ */
+class LinearAllocator
+{
+private:
+  struct Block
+  {
+    std::unique_ptr<char[]> Memory;
+    size_t Size;
+  };
+
+  std::vector<Block> m_Blocks;
+  size_t m_BlockSize;
+  size_t m_Block;  // block being handed out from
+  size_t m_Offset; // into that block
+  size_t m_Used;
+
+public:
+  LinearAllocator(size_t blockSize = 64 * 1024);
+
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  template <typename T, typename... Args> T* New(Args&&... args)
+  {
+    static_assert(std::is_trivially_destructible_v<T>,
+        "LinearAllocator never runs destructors");
+    return new (Allocate(sizeof(T), alignof(T)))
+        T { std::forward<Args>(args)... };
+  }
+
+  void Reset();
+
+  inline size_t GetUsed() const { return m_Used; }
+  size_t GetCapacity() const;
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "MappedFile.h"
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+MappedFile::MappedFile()
+    : m_Data(nullptr)
+    , m_Size(0)
+{
+}
+
+MappedFile::MappedFile(const std::string& filepath)
+    : MappedFile()
+{
+  Open(filepath);
+}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string& filepath)
+{
+  Close();
+#ifdef __unix__
+  int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat info;
+  if (fstat(fd, &info) == 0 && info.st_size > 0)
+  {
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      m_Data = (const unsigned char*)data;
+      m_Size = info.st_size;
+    }
+  }
+  close(fd); // the mapping keeps the file alive
+#else
+  std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+  if (!in) return false;
+  m_Buffer.resize((size_t)in.tellg());
+  in.seekg(0);
+  in.read((char*)m_Buffer.data(), m_Buffer.size());
+  if (in && !m_Buffer.empty())
+  {
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+  }
+#endif
+  return IsOpen();
+}
+
+void MappedFile::Close()
+{
+#ifdef __unix__
+  if (m_Data) munmap((void*)m_Data, m_Size);
+#endif
+  m_Buffer.clear();
+  m_Data = nullptr;
+  m_Size = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+ * A whole file, read only, through mmap. Opening costs a syscall or two and
+ * pages only come in as they're touched, so nothing is copied onto the heap
+ * and data that's never read is never loaded. Where there's no mmap the file
+ * is read into memory instead, same interface.
+ */
+class MappedFile
+{
+private:
+  const unsigned char* m_Data;
+  size_t m_Size;
+  std::vector<unsigned char> m_Buffer; // the fallback's copy
+
+public:
+  MappedFile();
+  MappedFile(const std::string& filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /* false if it can't be opened, empty files included */
+  bool Open(const std::string& filepath);
+  void Close();
+
+  inline bool IsOpen() const { return m_Data != nullptr; }
+  inline const unsigned char* GetData() const { return m_Data; }
+  inline size_t GetSize() const { return m_Size; }
+};
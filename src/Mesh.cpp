@@ -0,0 +1,83 @@
+#include "Mesh.h"
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "MeshImporter.h"
+#include "ResourcePack.h"
+
+Mesh::Mesh(const std::string& filepath)
+    : m_VertexCount(0)
+    , m_BoundsMin(0.0f)
+    , m_BoundsMax(0.0f)
+{
+  std::span<const unsigned char> packed = ResourcePack::Lookup(filepath);
+  MeshFile file;
+  if (packed.empty() ? file.Open(filepath) : file.Open(packed))
+  {
+    Create(file.GetVertices(), file.GetVertexCount(), file.GetIndices(),
+        file.GetIndexCount(), file.GetIndexSize());
+    m_BoundsMin = file.GetBoundsMin();
+    m_BoundsMax = file.GetBoundsMax();
+    return;
+  }
+
+  MappedFile loose;
+  if (packed.empty() && loose.Open(filepath))
+    packed = std::span(loose.GetData(), loose.GetSize());
+  MeshData data;
+  if (!MeshImporter::ImportObj(std::string_view((const char*)packed.data(),
+                                   packed.size()),
+          data))
+  {
+    std::cout << "Can't load mesh " << filepath << std::endl;
+    return;
+  }
+  MeshImporter::Optimize(data);
+  Create(data);
+}
+
+Mesh::Mesh(const MeshData& data)
+    : m_VertexCount(0)
+    , m_BoundsMin(0.0f)
+    , m_BoundsMax(0.0f)
+{
+  Create(data);
+}
+
+void Mesh::Create(const MeshData& data)
+{
+  if (data.Vertices.empty()) return;
+  m_BoundsMin = m_BoundsMax = data.Vertices[0].Position;
+  for (const MeshVertex& vertex : data.Vertices)
+  {
+    m_BoundsMin = glm::min(m_BoundsMin, vertex.Position);
+    m_BoundsMax = glm::max(m_BoundsMax, vertex.Position);
+  }
+
+  if (MeshFile::GetIndexSize(data.Vertices.size()) == sizeof(unsigned short))
+  {
+    std::vector<unsigned short> narrow(data.Indices.begin(),
+        data.Indices.end());
+    Create(data.Vertices.data(), (unsigned int)data.Vertices.size(),
+        narrow.data(), (unsigned int)narrow.size(), sizeof(unsigned short));
+  }
+  else
+    Create(data.Vertices.data(), (unsigned int)data.Vertices.size(),
+        data.Indices.data(), (unsigned int)data.Indices.size(),
+        sizeof(unsigned int));
+}
+
+void Mesh::Create(const MeshVertex* vertices, unsigned int vertexCount,
+    const void* indices, unsigned int indexCount, unsigned int indexSize)
+{
+  m_VertexCount = vertexCount;
+  m_VertexBuffer = std::make_unique<VertexBuffer>(
+      vertices, vertexCount * (unsigned int)sizeof(MeshVertex));
+  m_VertexArray.AddBuffer<MeshVertex>(*m_VertexBuffer);
+  // with the array still bound, so the index buffer lands in it
+  m_IndexBuffer
+      = std::make_unique<IndexBuffer>(indices, indexCount, indexSize);
+  m_VertexArray.Unbind();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <memory>
+#include <string>
+
+#include "IndexBuffer.h"
+#include "MeshFile.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+template <> struct VertexFormat<MeshVertex>
+{
+  static constexpr auto Layout = MakeVertexLayout<MeshVertex>(
+      VERTEX_ATTRIBUTE(MeshVertex, Position),
+      MakeVertexAttribute<PackedNormal>(offsetof(MeshVertex, Normal)),
+      VERTEX_ATTRIBUTE(MeshVertex, TexCoord));
+};
+
+/*
+ * Indexed triangles on the GPU, ready for Renderer::Draw. A file meshbake
+ * wrote is mapped (or found in the mounted pack) and uploaded as it is;
+ * anything else is read as an OBJ, imported and optimized on the spot,
+ * which is fine for iterating on an asset and slow for shipping one.
+ */
+class Mesh
+{
+private:
+  VertexArray m_VertexArray;
+  std::unique_ptr<VertexBuffer> m_VertexBuffer;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  unsigned int m_VertexCount;
+  glm::vec3 m_BoundsMin, m_BoundsMax;
+
+public:
+  Mesh(const std::string& filepath);
+  /* uploaded as is, optimize it first */
+  Mesh(const MeshData& data);
+
+  inline bool IsLoaded() const { return m_IndexBuffer != nullptr; }
+  inline const VertexArray& GetVertexArray() const { return m_VertexArray; }
+  inline const IndexBuffer& GetIndexBuffer() const { return *m_IndexBuffer; }
+  inline unsigned int GetVertexCount() const { return m_VertexCount; }
+  inline const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+  inline const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
+
+private:
+  void Create(const MeshData& data);
+  void Create(const MeshVertex* vertices, unsigned int vertexCount,
+      const void* indices, unsigned int indexCount, unsigned int indexSize);
+};
@@ -0,0 +1,128 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <fstream>
+
+static const uint32_t MeshMagic = 0x4d4c474f; // "OGLM"
+static const uint32_t MeshVersion = 1;
+
+struct MeshFileHeader
+{
+  uint32_t Magic, Version, VertexCount, IndexCount, IndexSize, VertexStride;
+  float BoundsMin[3], BoundsMax[3];
+  uint32_t VertexOffset, IndexOffset;
+};
+
+static uint32_t AlignUp(uint32_t value) { return (value + 15) & ~15u; }
+
+/* every index names one of the vertices, or the GPU reads past the buffer */
+template <typename Index>
+static bool IndicesInRange(
+    const void* indices, uint32_t count, uint32_t vertexCount)
+{
+  const Index* index = (const Index*)indices;
+  for (uint32_t i = 0; i < count; i++)
+    if (index[i] >= vertexCount) return false;
+  return true;
+}
+
+MeshFile::MeshFile()
+    : m_Vertices(nullptr)
+    , m_Indices(nullptr)
+    , m_VertexCount(0)
+    , m_IndexCount(0)
+    , m_IndexSize(4)
+    , m_BoundsMin(0.0f)
+    , m_BoundsMax(0.0f)
+{
+}
+
+bool MeshFile::Open(const std::string& filepath)
+{
+  m_VertexCount = m_IndexCount = 0;
+  if (!m_File.Open(filepath)) return false;
+  return Open(std::span(m_File.GetData(), m_File.GetSize()));
+}
+
+bool MeshFile::Open(std::span<const unsigned char> file)
+{
+  m_VertexCount = m_IndexCount = 0;
+  if (file.size() < sizeof(MeshFileHeader)) return false;
+
+  const unsigned char* data = file.data();
+  const size_t size = file.size();
+  const auto* header = (const MeshFileHeader*)data;
+  if (header->Magic != MeshMagic || header->Version != MeshVersion
+      || header->VertexStride != sizeof(MeshVertex)
+      || header->IndexSize != GetIndexSize(header->VertexCount)
+      || header->IndexCount % 3 != 0
+      || (size_t)header->VertexOffset
+                 + (size_t)header->VertexCount * sizeof(MeshVertex)
+             > size
+      || (size_t)header->IndexOffset
+                 + (size_t)header->IndexCount * header->IndexSize
+             > size)
+    return false;
+  const void* indices = data + header->IndexOffset;
+  if (header->IndexSize == 2
+          ? !IndicesInRange<uint16_t>(
+              indices, header->IndexCount, header->VertexCount)
+          : !IndicesInRange<uint32_t>(
+              indices, header->IndexCount, header->VertexCount))
+    return false;
+
+  m_Vertices = (const MeshVertex*)(data + header->VertexOffset);
+  m_Indices = indices;
+  m_VertexCount = header->VertexCount;
+  m_IndexCount = header->IndexCount;
+  m_IndexSize = header->IndexSize;
+  m_BoundsMin = glm::vec3(
+      header->BoundsMin[0], header->BoundsMin[1], header->BoundsMin[2]);
+  m_BoundsMax = glm::vec3(
+      header->BoundsMax[0], header->BoundsMax[1], header->BoundsMax[2]);
+  return true;
+}
+
+bool MeshFile::Write(const std::string& filepath, const MeshData& mesh)
+{
+  if (mesh.Vertices.empty() || mesh.Indices.size() % 3 != 0) return false;
+
+  glm::vec3 min = mesh.Vertices[0].Position, max = min;
+  for (const MeshVertex& vertex : mesh.Vertices)
+  {
+    min = glm::min(min, vertex.Position);
+    max = glm::max(max, vertex.Position);
+  }
+
+  MeshFileHeader header = { MeshMagic, MeshVersion,
+    (uint32_t)mesh.Vertices.size(), (uint32_t)mesh.Indices.size(),
+    GetIndexSize(mesh.Vertices.size()), (uint32_t)sizeof(MeshVertex),
+    { min.x, min.y, min.z }, { max.x, max.y, max.z }, 0, 0 };
+  header.VertexOffset = AlignUp(sizeof(MeshFileHeader));
+  header.IndexOffset = AlignUp(
+      header.VertexOffset + header.VertexCount * (uint32_t)sizeof(MeshVertex));
+
+  std::ofstream out(filepath, std::ios::binary);
+  if (!out) return false;
+  out.write((const char*)&header, sizeof(header));
+  while ((uint32_t)out.tellp() < header.VertexOffset)
+    out.put(0);
+  out.write((const char*)mesh.Vertices.data(),
+      mesh.Vertices.size() * sizeof(MeshVertex));
+  while ((uint32_t)out.tellp() < header.IndexOffset)
+    out.put(0);
+  if (header.IndexSize == 2)
+  {
+    std::vector<uint16_t> narrow(mesh.Indices.begin(), mesh.Indices.end());
+    out.write((const char*)narrow.data(), narrow.size() * sizeof(uint16_t));
+  }
+  else
+    out.write((const char*)mesh.Indices.data(),
+        mesh.Indices.size() * sizeof(uint32_t));
+  return (bool)out;
+}
+
+uint32_t MeshFile::GetIndexSize(size_t vertexCount)
+{
+  return vertexCount <= 0x10000 ? 2 : 4;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/* 24 bytes. Normal is PackedNormal's bits, kept as a plain integer so the
+   CPU side (meshbake) needs no GL headers; Mesh.h gives GL the layout. */
+struct MeshVertex
+{
+  glm::vec3 Position;
+  uint32_t Normal;
+  glm::vec2 TexCoord;
+};
+
+/* A mesh on the CPU, indices always 32 bit until they're written out */
+struct MeshData
+{
+  std::vector<MeshVertex> Vertices;
+  std::vector<uint32_t> Indices; // triangle list
+};
+
+/*
+ * The mesh container meshbake writes, laid out so it's mapped and handed to
+ * glBufferData as is: vertices in MeshVertex layout, then indices, 16 bit
+ * whenever the vertex count allows.
+ *
+ *   "OGLM" version vertexCount indexCount indexSize vertexStride
+ *   boundsMin boundsMax vertexOffset indexOffset
+ *   vertex data, index data, each starting 16 byte aligned
+ */
+class MeshFile
+{
+private:
+  MappedFile m_File;
+  const MeshVertex* m_Vertices; // into the mapping
+  const void* m_Indices;
+  uint32_t m_VertexCount;
+  uint32_t m_IndexCount;
+  uint32_t m_IndexSize; // bytes, 2 or 4
+  glm::vec3 m_BoundsMin, m_BoundsMax;
+
+public:
+  MeshFile();
+
+  /* Maps `filepath` and checks it over, false if it's anything but a mesh
+     file meshbake wrote */
+  bool Open(const std::string& filepath);
+  /* same for a file already in memory, e.g. out of a ResourcePack; the
+     vertices and indices point into `file`, which has to outlive them */
+  bool Open(std::span<const unsigned char> file);
+
+  static bool Write(const std::string& filepath, const MeshData& mesh);
+
+  /* 2 if every index of a mesh with `vertexCount` vertices fits 16 bits */
+  static uint32_t GetIndexSize(size_t vertexCount);
+
+  inline const MeshVertex* GetVertices() const { return m_Vertices; }
+  inline uint32_t GetVertexCount() const { return m_VertexCount; }
+  inline const void* GetIndices() const { return m_Indices; }
+  inline uint32_t GetIndexCount() const { return m_IndexCount; }
+  inline uint32_t GetIndexSize() const { return m_IndexSize; }
+  inline const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+  inline const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
+};
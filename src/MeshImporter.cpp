@@ -0,0 +1,381 @@
+#include "MeshImporter.h"
+
+#include <GLM/gtc/packing.hpp>
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+#include <unordered_map>
+
+/* One corner of an OBJ face: 0 based indices into the v/vt/vn lists, -1 for
+   the ones it doesn't have */
+struct ObjCorner
+{
+  int32_t Position, TexCoord, Normal;
+  bool operator==(const ObjCorner&) const = default;
+};
+
+struct ObjCornerHash
+{
+  size_t operator()(const ObjCorner& corner) const
+  {
+    uint64_t hash = (uint32_t)corner.Position;
+    hash = hash * 0x9e3779b97f4a7c15ull + (uint32_t)corner.TexCoord;
+    hash = hash * 0x9e3779b97f4a7c15ull + (uint32_t)corner.Normal;
+    return (size_t)(hash ^ hash >> 29);
+  }
+};
+
+static void SkipSpaces(std::string_view& text)
+{
+  while (!text.empty() && (text[0] == ' ' || text[0] == '\t'))
+    text.remove_prefix(1);
+}
+
+static bool ParseFloat(std::string_view& text, float& value)
+{
+  SkipSpaces(text);
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(),
+      value);
+  if (error != std::errc()) return false;
+  text.remove_prefix(end - text.data());
+  return true;
+}
+
+static bool ParseIndex(std::string_view& text, size_t count, int32_t& index)
+{
+  int value;
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(),
+      value);
+  if (error != std::errc() || value == 0) return false;
+  text.remove_prefix(end - text.data());
+  // 1 based, negative counts back from the last one read so far
+  index = value > 0 ? value - 1 : (int32_t)count + value;
+  return index >= 0 && (size_t)index < count;
+}
+
+bool MeshImporter::ImportObj(std::string_view text, MeshData& mesh)
+{
+  std::vector<glm::vec3> positions, normals;
+  std::vector<glm::vec2> texCoords;
+  std::vector<glm::vec3> vertexNormals; // unpacked until the end
+  std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> corners;
+  std::vector<uint32_t> face;
+  mesh.Vertices.clear();
+  mesh.Indices.clear();
+
+  while (!text.empty())
+  {
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    SkipSpaces(line);
+
+    glm::vec3 v(0.0f);
+    if (line.starts_with("v "))
+    {
+      line.remove_prefix(2);
+      if (ParseFloat(line, v.x) && ParseFloat(line, v.y)
+          && ParseFloat(line, v.z))
+        positions.push_back(v);
+    }
+    else if (line.starts_with("vt "))
+    {
+      line.remove_prefix(3);
+      if (ParseFloat(line, v.x) && ParseFloat(line, v.y))
+        texCoords.push_back(glm::vec2(v));
+    }
+    else if (line.starts_with("vn "))
+    {
+      line.remove_prefix(3);
+      if (ParseFloat(line, v.x) && ParseFloat(line, v.y)
+          && ParseFloat(line, v.z))
+        normals.push_back(v);
+    }
+    else if (line.starts_with("f "))
+    {
+      line.remove_prefix(2);
+      face.clear();
+      for (SkipSpaces(line); !line.empty() && line[0] != '\r';
+           SkipSpaces(line))
+      {
+        // p, p/t, p//n or p/t/n
+        ObjCorner corner = { -1, -1, -1 };
+        bool ok = ParseIndex(line, positions.size(), corner.Position);
+        if (ok && line.starts_with('/'))
+        {
+          line.remove_prefix(1);
+          if (!line.starts_with('/'))
+            ok = ParseIndex(line, texCoords.size(), corner.TexCoord);
+          if (ok && line.starts_with('/'))
+          {
+            line.remove_prefix(1);
+            ok = ParseIndex(line, normals.size(), corner.Normal);
+          }
+        }
+        if (!ok) return false;
+
+        auto [found, added]
+            = corners.try_emplace(corner, (uint32_t)mesh.Vertices.size());
+        if (added)
+        {
+          mesh.Vertices.push_back({ positions[corner.Position], 0,
+            corner.TexCoord < 0 ? glm::vec2(0.0f)
+                                : texCoords[corner.TexCoord] });
+          vertexNormals.push_back(
+              corner.Normal < 0 ? glm::vec3(0.0f) : normals[corner.Normal]);
+        }
+        face.push_back(found->second);
+      }
+      for (size_t i = 2; i < face.size(); i++)
+        mesh.Indices.insert(
+            mesh.Indices.end(), { face[0], face[i - 1], face[i] });
+    }
+  }
+  if (mesh.Indices.empty()) return false;
+
+  if (normals.empty())
+    for (size_t i = 0; i < mesh.Indices.size(); i += 3)
+    {
+      const uint32_t a = mesh.Indices[i], b = mesh.Indices[i + 1],
+                     c = mesh.Indices[i + 2];
+      // twice the area long, so bigger faces count for more
+      const glm::vec3 n
+          = glm::cross(mesh.Vertices[b].Position - mesh.Vertices[a].Position,
+              mesh.Vertices[c].Position - mesh.Vertices[a].Position);
+      vertexNormals[a] += n;
+      vertexNormals[b] += n;
+      vertexNormals[c] += n;
+    }
+  for (size_t i = 0; i < mesh.Vertices.size(); i++)
+  {
+    const glm::vec3& n = vertexNormals[i];
+    const float length = glm::length(n);
+    mesh.Vertices[i].Normal = glm::packSnorm3x10_1x2(
+        glm::vec4(length > 0.0f ? n / length : glm::vec3(0.0f), 0.0f));
+  }
+  return true;
+}
+
+void MeshImporter::Optimize(MeshData& mesh)
+{
+  std::vector<uint32_t> clusters
+      = OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+  OptimizeOverdraw(mesh, clusters);
+  OptimizeVertexFetch(mesh);
+}
+
+std::vector<uint32_t> MeshImporter::OptimizeVertexCache(
+    std::vector<uint32_t>& indices, size_t vertexCount,
+    unsigned int cacheSize /*= CacheSize */)
+{
+  const size_t triangleCount = indices.size() / 3;
+
+  // triangles around each vertex, and how many of them are still to go
+  std::vector<uint32_t> live(vertexCount, 0);
+  for (uint32_t index : indices)
+    live[index]++;
+  std::vector<uint32_t> offsets(vertexCount + 1, 0);
+  std::partial_sum(live.begin(), live.end(), offsets.begin() + 1);
+  std::vector<uint32_t> adjacency(indices.size());
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < indices.size(); i++)
+    adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+
+  // a vertex is in the cache if it went in less than cacheSize misses ago
+  std::vector<uint32_t> timestamps(vertexCount, 0);
+  uint32_t time = cacheSize + 1;
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<uint32_t> deadEnd, candidates, output;
+  std::vector<uint32_t> clusters = { 0 };
+  deadEnd.reserve(indices.size());
+  output.reserve(indices.size());
+  size_t cursor = 0; // for when the dead-end stack runs dry too
+
+  auto nextUnfinished = [&]() -> int64_t {
+    while (!deadEnd.empty())
+    {
+      const uint32_t vertex = deadEnd.back();
+      deadEnd.pop_back();
+      if (live[vertex] > 0) return vertex;
+    }
+    while (cursor < vertexCount && live[cursor] == 0)
+      cursor++;
+    return cursor < vertexCount ? (int64_t)cursor : -1;
+  };
+
+  int64_t fanning = nextUnfinished();
+  while (fanning >= 0)
+  {
+    candidates.clear();
+    for (uint32_t i = offsets[fanning]; i < offsets[fanning + 1]; i++)
+    {
+      const uint32_t triangle = adjacency[i];
+      if (emitted[triangle]) continue;
+      for (unsigned int corner = 0; corner < 3; corner++)
+      {
+        const uint32_t vertex = indices[triangle * 3 + corner];
+        output.push_back(vertex);
+        deadEnd.push_back(vertex);
+        candidates.push_back(vertex);
+        live[vertex]--;
+        if (time - timestamps[vertex] > cacheSize) timestamps[vertex] = time++;
+      }
+      emitted[triangle] = true;
+    }
+
+    /* The neighbour that's been in the cache longest but will still be
+       there after its remaining triangles go through, the others score 0 */
+    int64_t next = -1;
+    int64_t best = -1;
+    for (uint32_t vertex : candidates)
+    {
+      if (live[vertex] == 0) continue;
+      int64_t priority = 0;
+      if (time - timestamps[vertex] + 2 * live[vertex] <= cacheSize)
+        priority = time - timestamps[vertex];
+      if (priority > best)
+      {
+        best = priority;
+        next = vertex;
+      }
+    }
+    if (next < 0)
+    {
+      // nowhere local to go, whatever comes next starts a cluster
+      next = nextUnfinished();
+      if (next >= 0) clusters.push_back((uint32_t)(output.size() / 3));
+    }
+    fanning = next;
+  }
+  indices.swap(output);
+  return clusters;
+}
+
+void MeshImporter::OptimizeOverdraw(MeshData& mesh,
+    const std::vector<uint32_t>& clusters, float threshold /*= 1.05f */)
+{
+  std::vector<uint32_t>& indices = mesh.Indices;
+  const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+  if (triangleCount == 0) return;
+
+  /* Split the clusters further wherever the part before the split would
+     be no worse for the cache on its own than `threshold` times the whole
+     mesh. More, smaller clusters sort better. */
+  const float limit = threshold
+                      * ComputeACMR(indices, mesh.Vertices.size(),
+                          CacheSize);
+  std::vector<uint32_t> timestamps(mesh.Vertices.size(), 0);
+  uint32_t time = CacheSize + 1;
+  std::vector<uint32_t> starts;
+  for (size_t c = 0; c < clusters.size(); c++)
+  {
+    const uint32_t end
+        = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+    uint32_t start = clusters[c], misses = 0;
+    starts.push_back(start);
+    time += CacheSize + 1; // start cold, as if nothing came before
+    for (uint32_t triangle = start; triangle < end; triangle++)
+    {
+      for (unsigned int corner = 0; corner < 3; corner++)
+      {
+        const uint32_t vertex = indices[triangle * 3 + corner];
+        if (time - timestamps[vertex] > CacheSize)
+        {
+          timestamps[vertex] = time++;
+          misses++;
+        }
+      }
+      // a few triangles in, so one cheap one doesn't make a cluster
+      const uint32_t done = triangle - start + 1;
+      if (done >= CacheSize && triangle + 1 < end
+          && (float)misses / done <= limit)
+      {
+        start = triangle + 1;
+        misses = 0;
+        starts.push_back(start);
+        time += CacheSize + 1;
+      }
+    }
+  }
+
+  /* Sort by how far each cluster faces out from the middle of the mesh:
+     the outside gets drawn first and hides what's behind it */
+  glm::vec3 middle(0.0f);
+  for (const MeshVertex& vertex : mesh.Vertices)
+    middle += vertex.Position;
+  middle /= (float)mesh.Vertices.size();
+
+  struct Cluster
+  {
+    uint32_t Start, End;
+    float Facing;
+  };
+  std::vector<Cluster> sorted(starts.size());
+  for (size_t i = 0; i < starts.size(); i++)
+  {
+    Cluster& cluster = sorted[i];
+    cluster.Start = starts[i];
+    cluster.End = i + 1 < starts.size() ? starts[i + 1] : triangleCount;
+
+    glm::vec3 centroid(0.0f), normal(0.0f);
+    float area = 0.0f;
+    for (uint32_t triangle = cluster.Start; triangle < cluster.End;
+         triangle++)
+    {
+      const glm::vec3& a = mesh.Vertices[indices[triangle * 3]].Position;
+      const glm::vec3& b = mesh.Vertices[indices[triangle * 3 + 1]].Position;
+      const glm::vec3& c = mesh.Vertices[indices[triangle * 3 + 2]].Position;
+      const glm::vec3 n = glm::cross(b - a, c - a);
+      const float weight = glm::length(n);
+      centroid += (a + b + c) * (weight / 3.0f);
+      normal += n;
+      area += weight;
+    }
+    const float length = glm::length(normal);
+    cluster.Facing = area > 0.0f && length > 0.0f
+                         ? glm::dot(centroid / area - middle, normal / length)
+                         : 0.0f;
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+      [](const Cluster& a, const Cluster& b) { return a.Facing > b.Facing; });
+
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+  for (const Cluster& cluster : sorted)
+    output.insert(output.end(), indices.begin() + cluster.Start * 3,
+        indices.begin() + cluster.End * 3);
+  indices.swap(output);
+}
+
+void MeshImporter::OptimizeVertexFetch(MeshData& mesh)
+{
+  // first use order; anything never referenced is dropped
+  std::vector<uint32_t> remap(mesh.Vertices.size(), ~0u);
+  std::vector<MeshVertex> vertices;
+  vertices.reserve(mesh.Vertices.size());
+  for (uint32_t& index : mesh.Indices)
+  {
+    if (remap[index] == ~0u)
+    {
+      remap[index] = (uint32_t)vertices.size();
+      vertices.push_back(mesh.Vertices[index]);
+    }
+    index = remap[index];
+  }
+  mesh.Vertices.swap(vertices);
+}
+
+float MeshImporter::ComputeACMR(const std::vector<uint32_t>& indices,
+    size_t vertexCount, unsigned int cacheSize /*= CacheSize */)
+{
+  if (indices.empty()) return 0.0f;
+  std::vector<uint32_t> timestamps(vertexCount, 0);
+  uint32_t time = cacheSize + 1, misses = 0;
+  for (uint32_t index : indices)
+    if (time - timestamps[index] > cacheSize)
+    {
+      timestamps[index] = time++;
+      misses++;
+    }
+  return (float)misses / (indices.size() / 3);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "MeshFile.h"
+
+/*
+ * The offline half of MeshFile, CPU only like TextureBaker. Import reads an
+ * OBJ into one vertex per distinct position/texcoord/normal triple; Optimize
+ * then reorders it for the GPU, in three passes:
+ *
+ *  - triangles for the post-transform vertex cache, with Tipsify (Sander,
+ *    Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and
+ *    Reduced Overdraw"): fan out around one vertex at a time and move on to
+ *    the neighbour that's still in the cache and has the most left to emit
+ *  - the clusters that leaves, outward facing ones first, so the inside of
+ *    a mesh tends to fail the depth test rather than get shaded twice
+ *  - vertices in the order the triangles first use them, for fetch locality
+ *
+ * ACMR (average cache miss ratio) is vertex shader runs per triangle: 3 with
+ * no reuse at all, about 0.5 for a regular grid with a perfect cache.
+ */
+class MeshImporter
+{
+public:
+  static const unsigned int CacheSize = 16; // FIFO, what ACMR is measured on
+
+  /* Polygons are fanned into triangles; normals are generated (smooth, area
+     weighted) when the file has none. False if nothing usable was read. */
+  static bool ImportObj(std::string_view text, MeshData& mesh);
+
+  static void Optimize(MeshData& mesh);
+
+  /* Reorders `indices` in place; returns where each cluster starts */
+  static std::vector<uint32_t> OptimizeVertexCache(
+      std::vector<uint32_t>& indices, size_t vertexCount,
+      unsigned int cacheSize = CacheSize);
+  /* Reorders the clusters OptimizeVertexCache left in `mesh.Indices`;
+     `threshold` is how much worse than the whole mesh a cluster's ACMR can
+     get when it's split into smaller ones to sort */
+  static void OptimizeOverdraw(MeshData& mesh,
+      const std::vector<uint32_t>& clusters, float threshold = 1.05f);
+  static void OptimizeVertexFetch(MeshData& mesh);
+
+  static float ComputeACMR(const std::vector<uint32_t>& indices,
+      size_t vertexCount, unsigned int cacheSize = CacheSize);
+};
@@ -0,0 +1,119 @@
+#include "PixelReadback.h"
+
+#include <chrono>
+#include <cstring>
+
+PixelReadback::PixelReadback()
+    : m_First(0)
+    , m_Count(0)
+{
+}
+
+PixelReadback::~PixelReadback()
+{
+  for (Slot& slot : m_Slots)
+  {
+    if (slot.Fence)
+    {
+      GLCall(glDeleteSync(slot.Fence));
+    }
+    if (slot.Buffer)
+    {
+      GLState::ForgetBuffer(slot.Buffer);
+      GLCall(glDeleteBuffers(1, &slot.Buffer));
+    }
+  }
+}
+
+bool PixelReadback::Request(
+    int x, int y, int width, int height, uint64_t tag /*= 0 */)
+{
+  m_Stats.Requests++;
+  if (m_Count == MaxInFlight)
+  {
+    m_Stats.Dropped++;
+    return false;
+  }
+
+  Slot& slot = m_Slots[(m_First + m_Count++) % MaxInFlight];
+  const size_t size = (size_t)width * height * 4;
+  if (!slot.Buffer)
+  {
+    GLCall(glGenBuffers(1, &slot.Buffer));
+  }
+  GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+  if (size > slot.Capacity)
+  {
+    GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+    slot.Capacity = size;
+  }
+  // with a pack buffer bound the pointer is an offset into it
+  GLCall(glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0));
+  // or the next glReadPixels into client memory lands in here
+  GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  GLCall(slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  slot.Width = width;
+  slot.Height = height;
+  slot.Tag = tag;
+  return true;
+}
+
+bool PixelReadback::Poll(ReadbackImage& image)
+{
+  if (!m_Count) return false;
+  GLsync fence = m_Slots[m_First].Fence;
+  // flushed so the fence gets somewhere even if nothing else is submitted
+  GLCall(GLenum status
+      = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+  if (status == GL_TIMEOUT_EXPIRED) return false;
+  ASSERT(status != GL_WAIT_FAILED);
+  Take(image);
+  return true;
+}
+
+bool PixelReadback::Wait(ReadbackImage& image)
+{
+  if (!m_Count) return false;
+  GLsync fence = m_Slots[m_First].Fence;
+  GLCall(GLenum status = glClientWaitSync(fence, 0, 0));
+  if (status == GL_TIMEOUT_EXPIRED)
+  {
+    auto start = std::chrono::steady_clock::now();
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    do
+    {
+      GLCall(status = glClientWaitSync(fence, flags, 1000000));
+      flags = 0;
+    } while (status == GL_TIMEOUT_EXPIRED);
+    m_Stats.WaitMs += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start)
+                          .count();
+    m_Stats.Stalls++;
+  }
+  ASSERT(status != GL_WAIT_FAILED);
+  Take(image);
+  return true;
+}
+
+void PixelReadback::Take(ReadbackImage& image)
+{
+  Slot& slot = m_Slots[m_First];
+  const size_t size = (size_t)slot.Width * slot.Height * 4;
+  image.Width = slot.Width;
+  image.Height = slot.Height;
+  image.Tag = slot.Tag;
+  image.Pixels.resize(size);
+
+  GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+  GLCall(const void* data
+      = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+  ASSERT(data);
+  std::memcpy(image.Pixels.data(), data, size);
+  GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+  GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  GLCall(glDeleteSync(slot.Fence));
+  slot.Fence = nullptr;
+  m_First = (m_First + 1) % MaxInFlight;
+  m_Count--;
+}
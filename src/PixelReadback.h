@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Assert.h"
+#include "GLState.h"
+
+/* RGBA8, rows bottom up the way GL has them */
+struct ReadbackImage
+{
+  int Width = 0, Height = 0;
+  uint64_t Tag = 0; // whatever Request() was given, e.g. the frame
+  std::vector<unsigned char> Pixels;
+};
+
+struct ReadbackStats
+{
+  unsigned int Requests = 0;
+  unsigned int Dropped = 0; // asked for with MaxInFlight already pending
+  unsigned int Stalls = 0;  // Wait() calls that had to block
+  double WaitMs = 0.0;
+};
+
+/*
+ * Reads the bound framebuffer back without stalling on it. Request() has
+ * glReadPixels write into a pixel pack buffer, which only queues the copy,
+ * and drops a fence behind it; Poll() hands over the oldest request once
+ * that fence has signaled, so pixels turn up a frame or two after they were
+ * drawn and the CPU never sits waiting for the GPU to catch up. Wait() is
+ * for when there's nothing left to overlap with, like the last frame.
+ *
+ * GL thread only.
+ */
+class PixelReadback
+{
+public:
+  static const unsigned int MaxInFlight = 3;
+
+private:
+  struct Slot
+  {
+    unsigned int Buffer = 0;
+    size_t Capacity = 0; // bytes, grows to the biggest request
+    GLsync Fence = nullptr;
+    int Width = 0, Height = 0;
+    uint64_t Tag = 0;
+  };
+
+  std::array<Slot, MaxInFlight> m_Slots;
+  unsigned int m_First; // oldest pending
+  unsigned int m_Count;
+  ReadbackStats m_Stats;
+
+public:
+  PixelReadback();
+  ~PixelReadback();
+
+  PixelReadback(const PixelReadback&) = delete;
+  PixelReadback& operator=(const PixelReadback&) = delete;
+
+  /* false if MaxInFlight are still pending, nothing is read then */
+  bool Request(int x, int y, int width, int height, uint64_t tag = 0);
+  /* the oldest request if it's done, without blocking */
+  bool Poll(ReadbackImage& image);
+  /* the oldest request, blocking until it's done; false with none pending */
+  bool Wait(ReadbackImage& image);
+
+  inline unsigned int GetPending() const { return m_Count; }
+  inline const ReadbackStats& GetStats() const { return m_Stats; }
+
+private:
+  void Take(ReadbackImage& image);
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*
+ * Fixed-size object pool. Every slot holds one T; Delete() puts the slot on
+ * an intrusive free list and New() takes from there before it makes any
+ * more. Slots come in blocks of `blockSize` that are kept until the pool
+ * goes, so once it has seen its high-water mark it never touches the heap
+ * again, however much churn there is.
+ *
+ * Delete() runs the destructor, anything still live when the pool is
+ * destroyed just has its memory released. One thread, it doesn't lock.
+ */
+template <typename T> class Pool
+{
+private:
+  union Slot
+  {
+    Slot* Next;
+    alignas(T) unsigned char Object[sizeof(T)];
+  };
+
+  std::vector<std::unique_ptr<Slot[]>> m_Blocks;
+  Slot* m_Free;
+  size_t m_BlockSize;
+  size_t m_Used;
+
+public:
+  Pool(size_t blockSize = 256)
+      : m_Free(nullptr)
+      , m_BlockSize(blockSize)
+      , m_Used(0)
+  {
+  }
+
+  template <typename... Args> T* New(Args&&... args)
+  {
+    if (!m_Free) Grow();
+    Slot* slot = m_Free;
+    m_Free = slot->Next;
+    m_Used++;
+    return new (slot->Object) T { std::forward<Args>(args)... };
+  }
+
+  void Delete(T* object)
+  {
+    object->~T();
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    slot->Next = m_Free;
+    m_Free = slot;
+    m_Used--;
+  }
+
+  inline size_t GetUsed() const { return m_Used; }
+  inline size_t GetCapacity() const { return m_Blocks.size() * m_BlockSize; }
+
+private:
+  void Grow()
+  {
+    m_Blocks.push_back(std::make_unique<Slot[]>(m_BlockSize));
+    Slot* block = m_Blocks.back().get();
+    // backwards, so they come out in address order
+    for (size_t i = m_BlockSize; i-- > 0;)
+    {
+      block[i].Next = m_Free;
+      m_Free = &block[i];
+    }
+  }
+};
\ No newline at end of file
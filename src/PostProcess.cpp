@@ -0,0 +1,122 @@
+#include "PostProcess.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "RenderStats.h"
+
+PostProcess::PostProcess(int width, int height, Shader& downsample,
+    Shader& upsample, Shader& tonemap)
+    : m_Width(width)
+    , m_Height(height)
+    , m_Downsample(downsample)
+    , m_Upsample(upsample)
+    , m_Tonemap(tonemap)
+    , m_Scene(nullptr)
+{
+  // samplers never move, only what's bound to them
+  m_Downsample.Bind();
+  m_Downsample.SetUniform1i("u_Source", 0);
+  m_Upsample.Bind();
+  m_Upsample.SetUniform1i("u_Source", 0);
+  m_Tonemap.Bind();
+  m_Tonemap.SetUniform1i("u_Scene", 0);
+  m_Tonemap.SetUniform1i("u_Bloom", 1);
+}
+
+void PostProcess::SetSettings(const PostProcessSettings& settings)
+{
+  m_Settings = settings;
+  m_Settings.RenderScale = std::clamp(m_Settings.RenderScale, 0.25f, 2.0f);
+  m_Settings.BloomLevels =
+      std::clamp(m_Settings.BloomLevels, 1u, MaxBloomLevels);
+}
+
+int PostProcess::GetSceneWidth() const
+{
+  return std::max(1, (int)std::lround(m_Width * m_Settings.RenderScale));
+}
+
+int PostProcess::GetSceneHeight() const
+{
+  return std::max(1, (int)std::lround(m_Height * m_Settings.RenderScale));
+}
+
+void PostProcess::Begin()
+{
+  ASSERT(!m_Scene);
+  m_Scene = m_Pool.Acquire(
+      { GetSceneWidth(), GetSceneHeight(), ColorFormat::RGBA16F, true });
+  m_Scene->Bind();
+  GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+}
+
+void PostProcess::End(unsigned int framebuffer)
+{
+  ASSERT(m_Scene);
+  // every pass overwrites its whole target
+  GLState::SetBlend(false);
+  m_Fullscreen.Bind();
+
+  Framebuffer* bloom = nullptr;
+  if (m_Settings.Bloom)
+  {
+    /* down: level 0 is half the scene, thresholded */
+    Framebuffer* pyramid[MaxBloomLevels];
+    unsigned int levels = 0;
+    int width = m_Scene->GetWidth(), height = m_Scene->GetHeight();
+    const Framebuffer* source = m_Scene;
+    m_Downsample.Bind();
+    while (levels < m_Settings.BloomLevels && width > 1 && height > 1)
+    {
+      width /= 2;
+      height /= 2;
+      pyramid[levels] = m_Pool.Acquire(
+          { width, height, ColorFormat::R11G11B10F, false });
+      pyramid[levels]->Bind();
+      source->BindColor(0);
+      m_Downsample.SetUniform1f("u_Threshold", m_Settings.BloomThreshold);
+      m_Downsample.SetUniform1f(
+          "u_Knee", levels == 0 ? std::max(m_Settings.BloomKnee, 1e-3f) : 0.0f);
+      Draw();
+      source = pyramid[levels++];
+    }
+
+    /* up: each level's blur is added onto the one above it, in place, and
+       the level below goes back to the pool once it's been read */
+    GLState::SetBlend(true, GL_ONE, GL_ONE);
+    m_Upsample.Bind();
+    for (unsigned int i = levels; i-- > 1;)
+    {
+      pyramid[i - 1]->Bind();
+      pyramid[i]->BindColor(0);
+      Draw();
+      m_Pool.Release(pyramid[i]);
+    }
+    GLState::SetBlend(false);
+    if (levels > 0) bloom = pyramid[0];
+  }
+
+  /* tone map into the output, the sampler does the rescale */
+  Framebuffer::BindDefault(framebuffer, m_Width, m_Height);
+  m_Tonemap.Bind();
+  m_Scene->BindColor(0);
+  // no bloom reads the scene again with nothing of it added
+  (bloom ? bloom : m_Scene)->BindColor(1);
+  m_Tonemap.SetUniform1f(
+      "u_BloomIntensity", bloom ? m_Settings.BloomIntensity : 0.0f);
+  m_Tonemap.SetUniform1f("u_Exposure", m_Settings.Exposure);
+  Draw();
+
+  if (bloom) m_Pool.Release(bloom);
+  m_Pool.Release(m_Scene);
+  m_Scene = nullptr;
+  m_Pool.EndFrame();
+  GLState::SetBlend(true);
+}
+
+void PostProcess::Draw()
+{
+  GLCall(glDrawArrays(GL_TRIANGLES, 0, 3));
+  RenderStats::Get().DrawCalls++;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Framebuffer.h"
+#include "RenderTargetPool.h"
+#include "Shader.h"
+#include "VertexArray.h"
+
+struct PostProcessSettings
+{
+  float RenderScale = 1.0f; // scene resolution over the output's, 0.25..2
+  bool Bloom = true;
+  float BloomThreshold = 1.0f; // scene brightness bloom starts at
+  float BloomKnee = 0.5f;      // how far below that it fades in
+  float BloomIntensity = 0.3f;
+  unsigned int BloomLevels = 5; // mips in the pyramid, at most MaxBloomLevels
+  float Exposure = 1.0f;
+};
+
+/*
+ * The scene goes into an HDR target instead of the screen, then through:
+ *
+ *  - a downsample pyramid, each level half the last, the first one keeping
+ *    only what's over the bloom threshold
+ *  - an upsample back up it, a tent blur of every level added onto the one
+ *    above, so the top of the pyramid ends up holding the whole bloom
+ *  - tone mapping (ACES) of scene + bloom into the output framebuffer, which
+ *    also scales from the render resolution to the output's
+ *
+ * Every target comes from a RenderTargetPool by size and format and goes
+ * back as soon as the last pass reading it is done, so anything else asking
+ * for the same spec later in the frame gets the same memory, and after the
+ * first frame the chain creates nothing at all. The pyramid ping-pongs:
+ * each pass reads one level and writes its neighbour. Passes are fullscreen
+ * triangles without any vertex data.
+ */
+class PostProcess
+{
+public:
+  static const unsigned int MaxBloomLevels = 8;
+
+private:
+  int m_Width, m_Height; // output
+  PostProcessSettings m_Settings;
+  RenderTargetPool m_Pool;
+  Shader& m_Downsample;
+  Shader& m_Upsample;
+  Shader& m_Tonemap;
+  VertexArray m_Fullscreen; // empty, the shaders make up the triangle
+  Framebuffer* m_Scene;     // between Begin() and End()
+
+public:
+  PostProcess(int width, int height, Shader& downsample, Shader& upsample,
+      Shader& tonemap);
+
+  /* binds and clears the scene target, draw the frame after this */
+  void Begin();
+  /* runs the chain and leaves `framebuffer` bound, at the output size */
+  void End(unsigned int framebuffer);
+
+  inline const PostProcessSettings& GetSettings() const { return m_Settings; }
+  void SetSettings(const PostProcessSettings& settings);
+
+  /* the size Begin() renders at */
+  int GetSceneWidth() const;
+  int GetSceneHeight() const;
+
+  inline const RenderTargetStats& GetStats() const { return m_Pool.GetStats(); }
+  inline void ResetStats() { m_Pool.ResetStats(); }
+
+private:
+  void Draw();
+};
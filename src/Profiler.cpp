@@ -0,0 +1,373 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "Assert.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+const unsigned int NoScope = ~0u;
+
+/* a frame that's been recorded, waiting on its timestamp queries */
+struct PendingFrame
+{
+  ProfileFrame Frame;
+  unsigned int GpuScopes = 0; // timestamp pairs used, pair 0 is the frame
+  double GpuOffsetMs = 0.0;   // add to a GPU timestamp to get CPU ms
+  bool Waiting = false;
+};
+
+Clock::time_point s_Epoch = Clock::now();
+ProfileRing s_Ring(512);
+PendingFrame s_Pending[Profiler::GpuLatency];
+GLuint s_Queries[Profiler::GpuLatency][Profiler::MaxGpuScopes * 2];
+bool s_GpuTimers = false;
+uint64_t s_Frame = 0;    // being recorded, or the next one to be
+uint64_t s_Resolved = 0; // next one to go into the ring
+unsigned int s_GpuDropped = 0;
+unsigned short s_GpuDepth = 0;
+std::atomic<bool> s_Recording = false;
+std::atomic<unsigned int> s_ScopeCount = 0;
+std::atomic<unsigned short> s_NextThread = 0;
+
+thread_local unsigned short t_Thread = s_NextThread.fetch_add(1);
+thread_local unsigned short t_Depth = 0;
+
+inline PendingFrame& Current()
+{
+  return s_Pending[s_Frame % Profiler::GpuLatency];
+}
+
+inline GLuint* Queries(const PendingFrame& pending)
+{
+  return s_Queries[&pending - s_Pending];
+}
+
+/* scope ids carry the pending slot so a late EndCpu can't land in the wrong
+   frame */
+unsigned int AllocateScope(const char* name, unsigned short depth,
+    unsigned short thread, unsigned int query)
+{
+  const unsigned int index = s_ScopeCount.fetch_add(1);
+  if (index >= ProfileFrame::MaxScopes) return NoScope;
+  PendingFrame& pending = Current();
+  pending.Frame.Scopes[index]
+      = { name, Profiler::NowMs(), 0.0, depth, thread, query };
+  const unsigned int slot = (unsigned int)(&pending - s_Pending);
+  return slot * ProfileFrame::MaxScopes + index;
+}
+
+inline ProfileScope& ScopeFor(unsigned int scope)
+{
+  return s_Pending[scope / ProfileFrame::MaxScopes]
+      .Frame.Scopes[scope % ProfileFrame::MaxScopes];
+}
+
+double ReadTimestamp(GLuint query, double offsetMs)
+{
+  GLuint64 ns = 0;
+  GLCall(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns));
+  return ns / 1e6 + offsetMs;
+}
+
+/* Pushes the frame into the ring if its queries are back. With `force` it
+   goes in regardless, minus the GPU times if they aren't. */
+bool Resolve(PendingFrame& pending, bool force)
+{
+  ProfileFrame& frame = pending.Frame;
+  if (s_GpuTimers)
+  {
+    // timestamps land in order and the frame's end went in last, so if
+    // that one's back they all are
+    const GLuint* queries = Queries(pending);
+    GLuint available = GL_FALSE;
+    GLCall(glGetQueryObjectuiv(
+        queries[1], GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available && !force) return false;
+    frame.HasGpu = available;
+    if (available)
+    {
+      frame.GpuStartMs = ReadTimestamp(queries[0], pending.GpuOffsetMs);
+      frame.GpuEndMs = ReadTimestamp(queries[1], pending.GpuOffsetMs);
+      for (unsigned int i = 0; i < frame.ScopeCount; i++)
+      {
+        ProfileScope& scope = frame.Scopes[i];
+        if (scope.Thread != ProfileFrame::GpuThread) continue;
+        const GLuint* pair = queries + scope.Query * 2;
+        scope.StartMs = ReadTimestamp(pair[0], pending.GpuOffsetMs);
+        scope.EndMs = ReadTimestamp(pair[1], pending.GpuOffsetMs);
+      }
+    }
+    else
+      s_GpuDropped++;
+  }
+  s_Ring.Push(frame);
+  pending.Waiting = false;
+  return true;
+}
+}
+
+ProfileRing::ProfileRing(size_t capacity)
+    : m_Slots(new Slot[capacity])
+    , m_Capacity(capacity)
+    , m_Written(0)
+{
+}
+
+void ProfileRing::Push(const ProfileFrame& frame)
+{
+  const uint64_t index = m_Written.load(std::memory_order_relaxed);
+  Slot& slot = m_Slots[index % m_Capacity];
+  slot.Sequence.store(index * 2 + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.Frame = frame;
+  slot.Sequence.store(index * 2 + 2, std::memory_order_release);
+  m_Written.store(index + 1, std::memory_order_release);
+}
+
+bool ProfileRing::Read(uint64_t index, ProfileFrame& out) const
+{
+  const Slot& slot = m_Slots[index % m_Capacity];
+  const uint64_t sequence = index * 2 + 2;
+  if (slot.Sequence.load(std::memory_order_acquire) != sequence) return false;
+  out = slot.Frame;
+  // the writer may have lapped us halfway through the copy
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.Sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+void Profiler::Init()
+{
+  (void)t_Thread; // so the GL thread is thread 0
+  s_GpuTimers = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+  if (s_GpuTimers)
+  {
+    GLCall(glGenQueries(GpuLatency * MaxGpuScopes * 2, &s_Queries[0][0]));
+  }
+  else
+    std::cout << "[Profiler] No timer queries, GPU scopes are off"
+              << std::endl;
+}
+
+void Profiler::Shutdown()
+{
+  ASSERT(!s_Recording);
+  // it's shutdown, so wait for the last few frames rather than lose them
+  GLCall(glFinish());
+  for (; s_Resolved < s_Frame; s_Resolved++)
+    Resolve(s_Pending[s_Resolved % GpuLatency], true);
+  if (s_GpuTimers)
+  {
+    GLCall(glDeleteQueries(GpuLatency * MaxGpuScopes * 2, &s_Queries[0][0]));
+  }
+  s_GpuTimers = false;
+}
+
+void Profiler::BeginFrame()
+{
+  ASSERT(!s_Recording);
+  PendingFrame& pending = Current();
+  // GpuLatency frames and the queries still aren't in, don't wait for them
+  if (pending.Waiting)
+  {
+    Resolve(pending, true);
+    s_Resolved++;
+  }
+
+  ProfileFrame& frame = pending.Frame;
+  frame.Index = s_Frame;
+  frame.CpuStartMs = NowMs();
+  frame.HasGpu = false;
+  pending.GpuScopes = 1;
+  if (s_GpuTimers)
+  {
+    // GL's current time, without waiting on anything already queued
+    GLint64 now = 0;
+    GLCall(glGetInteger64v(GL_TIMESTAMP, &now));
+    pending.GpuOffsetMs = NowMs() - now / 1e6;
+    GLCall(glQueryCounter(Queries(pending)[0], GL_TIMESTAMP));
+  }
+  s_ScopeCount = 0;
+  s_GpuDepth = 0;
+  s_Recording = true;
+}
+
+void Profiler::EndFrame()
+{
+  ASSERT(s_Recording);
+  s_Recording = false;
+  PendingFrame& pending = Current();
+  ProfileFrame& frame = pending.Frame;
+  if (s_GpuTimers)
+  {
+    GLCall(glQueryCounter(Queries(pending)[1], GL_TIMESTAMP));
+  }
+  frame.CpuEndMs = NowMs();
+  const unsigned int count = s_ScopeCount;
+  frame.ScopeCount
+      = count < ProfileFrame::MaxScopes ? count : ProfileFrame::MaxScopes;
+  frame.Dropped = count - frame.ScopeCount;
+  // anything still open gets cut off at the end of the frame
+  for (unsigned int i = 0; i < frame.ScopeCount; i++)
+    if (frame.Scopes[i].Thread != ProfileFrame::GpuThread
+        && frame.Scopes[i].EndMs == 0.0)
+      frame.Scopes[i].EndMs = frame.CpuEndMs;
+  pending.Waiting = true;
+  s_Frame++;
+
+  // everything whose queries are back goes in, oldest first
+  while (s_Resolved < s_Frame
+      && Resolve(s_Pending[s_Resolved % GpuLatency], false))
+    s_Resolved++;
+}
+
+double Profiler::NowMs()
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - s_Epoch)
+      .count();
+}
+
+ProfileRing& Profiler::GetRing() { return s_Ring; }
+
+unsigned int Profiler::GetGpuDropped() { return s_GpuDropped; }
+
+unsigned int Profiler::BeginCpu(const char* name)
+{
+  if (!s_Recording.load(std::memory_order_relaxed)) return NoScope;
+  const unsigned int scope = AllocateScope(name, t_Depth, t_Thread, 0);
+  if (scope != NoScope) t_Depth++;
+  return scope;
+}
+
+void Profiler::EndCpu(unsigned int scope)
+{
+  if (scope == NoScope) return;
+  ScopeFor(scope).EndMs = NowMs();
+  t_Depth--;
+}
+
+unsigned int Profiler::BeginGpu(const char* name)
+{
+  if (!s_GpuTimers || !s_Recording) return NoScope;
+  PendingFrame& pending = Current();
+  if (pending.GpuScopes == MaxGpuScopes) return NoScope;
+  const unsigned int scope = AllocateScope(
+      name, s_GpuDepth, ProfileFrame::GpuThread, pending.GpuScopes);
+  if (scope == NoScope) return NoScope;
+  GLCall(glQueryCounter(
+      Queries(pending)[pending.GpuScopes * 2], GL_TIMESTAMP));
+  pending.GpuScopes++;
+  s_GpuDepth++;
+  return scope;
+}
+
+void Profiler::EndGpu(unsigned int scope)
+{
+  if (scope == NoScope) return;
+  const PendingFrame& pending = s_Pending[scope / ProfileFrame::MaxScopes];
+  GLCall(glQueryCounter(
+      Queries(pending)[ScopeFor(scope).Query * 2 + 1], GL_TIMESTAMP));
+  s_GpuDepth--;
+}
+
+ProfileCapture::ProfileCapture(const std::string& path)
+    : m_Path(path)
+    , m_Out(path)
+    , m_Stopping(false)
+    , m_Next(Profiler::GetRing().GetWritten())
+    , m_Frames(0)
+    , m_Missed(0)
+    , m_First(true)
+{
+  if (!m_Out)
+  {
+    std::cout << "[Profiler] Couldn't open " << path << " for the trace"
+              << std::endl;
+    return;
+  }
+  m_Out << std::fixed << std::setprecision(3)
+        << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  m_Thread = std::thread([this] {
+    while (!m_Stopping)
+    {
+      Drain();
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    Drain();
+  });
+}
+
+ProfileCapture::~ProfileCapture()
+{
+  if (!m_Thread.joinable()) return;
+  m_Stopping = true;
+  m_Thread.join();
+  m_Out << "\n]}\n";
+  std::cout << "[Profiler] Wrote " << m_Frames << " frames to " << m_Path;
+  if (m_Missed) std::cout << " (" << m_Missed << " lost, ring overran)";
+  std::cout << std::endl;
+}
+
+void ProfileCapture::Drain()
+{
+  const ProfileRing& ring = Profiler::GetRing();
+  const uint64_t written = ring.GetWritten();
+  if (written - m_Next > ring.GetCapacity())
+  {
+    m_Missed += written - ring.GetCapacity() - m_Next;
+    m_Next = written - ring.GetCapacity();
+  }
+  // too big to want on the stack, and only this thread touches it
+  static thread_local ProfileFrame frame;
+  for (; m_Next < written; m_Next++)
+  {
+    if (ring.Read(m_Next, frame))
+      WriteFrame(frame);
+    else
+      m_Missed++;
+  }
+}
+
+void ProfileCapture::WriteFrame(const ProfileFrame& frame)
+{
+  WriteEvent("Frame", 0, frame.CpuStartMs, frame.CpuEndMs);
+  if (frame.HasGpu)
+    WriteEvent("Frame", ProfileFrame::GpuThread, frame.GpuStartMs,
+        frame.GpuEndMs);
+  for (unsigned int i = 0; i < frame.ScopeCount; i++)
+  {
+    const ProfileScope& scope = frame.Scopes[i];
+    if (scope.Thread == ProfileFrame::GpuThread && !frame.HasGpu) continue;
+    WriteEvent(scope.Name, scope.Thread, scope.StartMs, scope.EndMs);
+  }
+  m_Frames++;
+}
+
+void ProfileCapture::WriteEvent(
+    const char* name, unsigned int thread, double startMs, double endMs)
+{
+  NameThread(thread);
+  m_Out << (m_First ? "\n" : ",\n") << "{\"name\":\"" << name
+        << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+        << ",\"ts\":" << startMs * 1000.0
+        << ",\"dur\":" << (endMs - startMs) * 1000.0 << "}";
+  m_First = false;
+}
+
+void ProfileCapture::NameThread(unsigned int thread)
+{
+  if (thread >= m_Named.size()) m_Named.resize(thread + 1);
+  if (m_Named[thread]) return;
+  m_Named[thread] = true;
+  std::string name = thread == ProfileFrame::GpuThread ? "GPU"
+      : thread == 0 ? "Main"
+                    : "Worker " + std::to_string(thread);
+  m_Out << (m_First ? "\n" : ",\n")
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << thread << ",\"args\":{\"name\":\"" << name << "\"}}";
+  m_First = false;
+}
\ No newline at end of file
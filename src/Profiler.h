@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* One timed region. Times are ms since Profiler::Init(), GPU ones included
+   (they're moved onto the CPU clock when they come back). */
+struct ProfileScope
+{
+  const char* Name; // string literal, never copied
+  double StartMs;
+  double EndMs;
+  unsigned short Depth;
+  unsigned short Thread; // ProfileFrame::GpuThread for GPU scopes
+  unsigned int Query;    // GPU scopes: which timestamp pair
+};
+
+struct ProfileFrame
+{
+  static const unsigned int MaxScopes = 128;
+  static const unsigned short GpuThread = 0xFFFF;
+
+  uint64_t Index = 0;
+  double CpuStartMs = 0.0;
+  double CpuEndMs = 0.0;
+  double GpuStartMs = 0.0;
+  double GpuEndMs = 0.0;
+  bool HasGpu = false;        // false if the queries weren't back in time
+  unsigned int ScopeCount = 0;
+  unsigned int Dropped = 0;   // scopes past MaxScopes
+  ProfileScope Scopes[MaxScopes];
+
+  inline double CpuMs() const { return CpuEndMs - CpuStartMs; }
+  inline double GpuMs() const { return HasGpu ? GpuEndMs - GpuStartMs : 0.0; }
+};
+
+/*
+ * History of finished frames. One writer (the GL thread, from EndFrame) and
+ * any number of readers, each with its own cursor, none of them ever taking a
+ * lock. The writer never waits: a reader that falls more than a ring behind
+ * just loses the frames it missed. Every slot has a sequence number that's
+ * odd while it's being written, Read() copies and then checks it didn't move.
+ */
+class ProfileRing
+{
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t> Sequence { 0 };
+    ProfileFrame Frame;
+  };
+
+  std::unique_ptr<Slot[]> m_Slots;
+  size_t m_Capacity;
+  std::atomic<uint64_t> m_Written;
+
+public:
+  ProfileRing(size_t capacity);
+
+  void Push(const ProfileFrame& frame);
+  /* Copies out frame number `index` (counting pushes from 0). False if it
+     hasn't been pushed yet or has already been overwritten. */
+  bool Read(uint64_t index, ProfileFrame& out) const;
+
+  inline uint64_t GetWritten() const
+  {
+    return m_Written.load(std::memory_order_acquire);
+  }
+  inline size_t GetCapacity() const { return m_Capacity; }
+};
+
+/*
+ * Frame profiler. CPU scopes are RAII and can open on any thread (the command
+ * buffer workers do); GPU scopes are timestamp queries, so GL thread only.
+ *
+ *   Profiler::BeginFrame();
+ *   {
+ *     PROFILE_SCOPE("Sprites");
+ *     PROFILE_GPU_SCOPE("Sprites");
+ *     ...
+ *   }
+ *   Profiler::EndFrame();
+ *
+ * GPU scopes are a pair of glQueryCounter(GL_TIMESTAMP) rather than a
+ * GL_TIME_ELAPSED query, since only one of those can be running at a time and
+ * scopes nest. The query sets are kept for GpuLatency frames and only read
+ * once GL says the results are in, so reading never stalls; if they still
+ * aren't after GpuLatency frames the frame goes into the ring without GPU
+ * times. Everything finished lands in GetRing() for whoever wants it (the
+ * ImGui panel, a trace capture).
+ */
+class Profiler
+{
+public:
+  static const unsigned int GpuLatency = 3;
+  static const unsigned int MaxGpuScopes = 32;
+
+  /* GL thread, after the context is up */
+  static void Init();
+  static void Shutdown();
+
+  static void BeginFrame();
+  static void EndFrame();
+
+  static double NowMs();
+  static ProfileRing& GetRing();
+  /* frames that went into the ring without GPU times */
+  static unsigned int GetGpuDropped();
+
+  /* Not for calling directly, the scope guards do this */
+  static unsigned int BeginCpu(const char* name);
+  static void EndCpu(unsigned int scope);
+  static unsigned int BeginGpu(const char* name);
+  static void EndGpu(unsigned int scope);
+};
+
+class ProfileCpuScope
+{
+private:
+  unsigned int m_Scope;
+
+public:
+  inline ProfileCpuScope(const char* name) : m_Scope(Profiler::BeginCpu(name))
+  {
+  }
+  inline ~ProfileCpuScope() { Profiler::EndCpu(m_Scope); }
+};
+
+class ProfileGpuScope
+{
+private:
+  unsigned int m_Scope;
+
+public:
+  inline ProfileGpuScope(const char* name) : m_Scope(Profiler::BeginGpu(name))
+  {
+  }
+  inline ~ProfileGpuScope() { Profiler::EndGpu(m_Scope); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)                                                    \
+  ProfileCpuScope PROFILE_CONCAT(profileCpu, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name)                                                \
+  ProfileGpuScope PROFILE_CONCAT(profileGpu, __LINE__)(name)
+
+/*
+ * Streams frames out of the ring into a Chrome trace-event JSON file (open it
+ * in chrome://tracing or Perfetto) from its own thread, from construction to
+ * destruction. One track per CPU thread plus one for the GPU.
+ */
+class ProfileCapture
+{
+private:
+  std::string m_Path;
+  std::ofstream m_Out;
+  std::thread m_Thread;
+  std::atomic<bool> m_Stopping;
+  uint64_t m_Next;         // ring index of the next frame to write
+  unsigned int m_Frames;
+  unsigned int m_Missed;   // overwritten before we got to them
+  std::vector<bool> m_Named; // thread_name metadata written for this track
+  bool m_First;
+
+public:
+  ProfileCapture(const std::string& path);
+  ~ProfileCapture();
+
+private:
+  void Drain();
+  void WriteFrame(const ProfileFrame& frame);
+  void WriteEvent(const char* name, unsigned int thread, double startMs,
+      double endMs);
+  void NameThread(unsigned int thread);
+};
\ No newline at end of file
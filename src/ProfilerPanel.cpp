@@ -0,0 +1,180 @@
+#include "ProfilerPanel.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <imgui.h>
+#include <utility>
+
+#include "FrameArena.h"
+
+namespace
+{
+const float LaneLabelWidth = 64.0f;
+const float RowHeight = 18.0f;
+
+/* same name, same colour, from one frame to the next */
+ImU32 ScopeColor(const char* name)
+{
+  unsigned int hash = 2166136261u;
+  for (const char* c = name; *c; c++)
+    hash = (hash ^ (unsigned char)*c) * 16777619u;
+  return IM_COL32(
+      60 + hash % 140, 60 + (hash >> 8) % 140, 60 + (hash >> 16) % 140, 255);
+}
+}
+
+ProfilerPanel::ProfilerPanel()
+    : m_Next(Profiler::GetRing().GetWritten())
+    , m_HasFrame(false)
+    , m_Paused(false)
+    , m_Head(0)
+    , m_CpuMs(HistoryLength)
+    , m_GpuMs(HistoryLength)
+{
+}
+
+void ProfilerPanel::Draw()
+{
+  const ProfileRing& ring = Profiler::GetRing();
+  const uint64_t written = ring.GetWritten();
+  if (m_Paused)
+    m_Next = written; // whatever comes in while paused is skipped
+  else if (written - m_Next > ring.GetCapacity())
+    m_Next = written - ring.GetCapacity();
+  ProfileFrame frame;
+  for (; m_Next < written; m_Next++)
+    if (ring.Read(m_Next, frame)) Consume(frame);
+
+  ImGui::Begin("Profiler");
+  ImGui::Checkbox("Pause", &m_Paused);
+  if (m_HasFrame)
+  {
+    ImGui::Text("Frame %llu: CPU %.3f ms, GPU %.3f ms, %u scopes (%u dropped)",
+        (unsigned long long)m_Frame.Index, m_Frame.CpuMs(), m_Frame.GpuMs(),
+        m_Frame.ScopeCount, m_Frame.Dropped);
+    ImGui::Text("%u frames went by without GPU times",
+        Profiler::GetGpuDropped());
+    DrawTimeline();
+  }
+  DrawHistogram("CPU frame", m_CpuMs);
+  DrawHistogram("GPU frame", m_GpuMs);
+  ImGui::Separator();
+  for (const ScopeHistory& scope : m_Scopes)
+  {
+    char label[64];
+    snprintf(label, sizeof(label), "%s %s", scope.Gpu ? "GPU" : "CPU",
+        scope.Name);
+    DrawHistogram(label, scope.Ms);
+  }
+  ImGui::End();
+}
+
+void ProfilerPanel::Consume(const ProfileFrame& frame)
+{
+  m_Frame = frame;
+  m_HasFrame = true;
+  m_CpuMs[m_Head] = (float)frame.CpuMs();
+  m_GpuMs[m_Head] = (float)frame.GpuMs();
+
+  // top level scopes only, summed when the same name shows up twice
+  for (ScopeHistory& scope : m_Scopes)
+    scope.Ms[m_Head] = 0.0f;
+  for (unsigned int i = 0; i < frame.ScopeCount; i++)
+  {
+    const ProfileScope& scope = frame.Scopes[i];
+    const bool gpu = scope.Thread == ProfileFrame::GpuThread;
+    if (scope.Depth || (gpu && !frame.HasGpu)) continue;
+    auto found = std::find_if(m_Scopes.begin(), m_Scopes.end(),
+        [&](const ScopeHistory& history) {
+          return history.Gpu == gpu && !strcmp(history.Name, scope.Name);
+        });
+    if (found == m_Scopes.end())
+    {
+      m_Scopes.push_back(
+          { scope.Name, gpu, std::vector<float>(HistoryLength) });
+      found = m_Scopes.end() - 1;
+    }
+    found->Ms[m_Head] += (float)(scope.EndMs - scope.StartMs);
+  }
+  m_Head = (m_Head + 1) % HistoryLength;
+}
+
+void ProfilerPanel::DrawTimeline()
+{
+  const ProfileFrame& frame = m_Frame;
+  double start = frame.CpuStartMs, end = frame.CpuEndMs;
+  if (frame.HasGpu)
+  {
+    start = std::min(start, frame.GpuStartMs);
+    end = std::max(end, frame.GpuEndMs);
+  }
+
+  // a lane per thread that showed up, as deep as its deepest scope; the GPU
+  // id is the biggest so it ends up at the bottom
+  using Lane = std::pair<unsigned short, unsigned short>;
+  std::vector<Lane, FrameAllocator<Lane>> lanes;
+  for (unsigned int i = 0; i < frame.ScopeCount; i++)
+  {
+    const ProfileScope& scope = frame.Scopes[i];
+    if (scope.Thread == ProfileFrame::GpuThread && !frame.HasGpu) continue;
+    auto lane = std::find_if(lanes.begin(), lanes.end(),
+        [&](const auto& lane) { return lane.first == scope.Thread; });
+    if (lane == lanes.end())
+      lanes.push_back({ scope.Thread, scope.Depth + 1 });
+    else
+      lane->second = std::max<unsigned short>(lane->second, scope.Depth + 1);
+  }
+  std::sort(lanes.begin(), lanes.end());
+
+  ImDrawList* draw = ImGui::GetWindowDrawList();
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const float width = ImGui::GetContentRegionAvailWidth();
+  const double scale = (width - LaneLabelWidth) / std::max(end - start, 1e-3);
+  float y = origin.y;
+  for (const auto& [thread, depth] : lanes)
+  {
+    char label[16];
+    if (thread == ProfileFrame::GpuThread)
+      snprintf(label, sizeof(label), "GPU");
+    else if (thread == 0)
+      snprintf(label, sizeof(label), "Main");
+    else
+      snprintf(label, sizeof(label), "Worker %u", thread);
+    draw->AddText(ImVec2(origin.x, y), IM_COL32(200, 200, 200, 255), label);
+
+    for (unsigned int i = 0; i < frame.ScopeCount; i++)
+    {
+      const ProfileScope& scope = frame.Scopes[i];
+      if (scope.Thread != thread) continue;
+      const float x0 = origin.x + LaneLabelWidth
+          + (float)((scope.StartMs - start) * scale);
+      const float x1 = std::max(x0 + 1.0f,
+          origin.x + LaneLabelWidth + (float)((scope.EndMs - start) * scale));
+      const ImVec2 min(x0, y + scope.Depth * RowHeight);
+      const ImVec2 max(x1, min.y + RowHeight - 1.0f);
+      draw->AddRectFilled(min, max, ScopeColor(scope.Name));
+      if (ImGui::CalcTextSize(scope.Name).x + 4.0f < x1 - x0)
+        draw->AddText(ImVec2(x0 + 2.0f, min.y + 2.0f),
+            IM_COL32(0, 0, 0, 255), scope.Name);
+      if (ImGui::IsMouseHoveringRect(min, max))
+        ImGui::SetTooltip(
+            "%s: %.3f ms", scope.Name, scope.EndMs - scope.StartMs);
+    }
+    y += depth * RowHeight + 4.0f;
+  }
+  ImGui::Dummy(ImVec2(width, y - origin.y));
+}
+
+void ProfilerPanel::DrawHistogram(
+    const char* label, const std::vector<float>& ms)
+{
+  const float latest = ms[(m_Head + HistoryLength - 1) % HistoryLength];
+  const float peak = *std::max_element(ms.begin(), ms.end());
+  char id[72], overlay[96];
+  snprintf(id, sizeof(id), "##%s", label);
+  snprintf(overlay, sizeof(overlay), "%s %.3f ms (max %.3f)", label, latest,
+      peak);
+  ImGui::PlotHistogram(id, ms.data(), (int)ms.size(), (int)m_Head, overlay,
+      0.0f, peak * 1.1f + 1e-3f, ImVec2(0.0f, 40.0f));
+}
\ No newline at end of file
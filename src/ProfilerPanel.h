@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Profiler.h"
+
+/*
+ * ImGui window over the profiler ring: a timeline of the newest frame with
+ * one lane per CPU thread and one for the GPU (children stacked under their
+ * parents, hover for the time), and rolling histograms of CPU and GPU frame
+ * time and of each top level scope. Only the game shows it, the bench
+ * captures traces instead.
+ */
+class ProfilerPanel
+{
+public:
+  static const unsigned int HistoryLength = 240;
+
+private:
+  struct ScopeHistory
+  {
+    const char* Name;
+    bool Gpu;
+    std::vector<float> Ms;
+  };
+
+  uint64_t m_Next; // ring cursor
+  ProfileFrame m_Frame;
+  bool m_HasFrame;
+  bool m_Paused;
+  unsigned int m_Head; // where the next history sample goes
+  std::vector<float> m_CpuMs;
+  std::vector<float> m_GpuMs;
+  std::vector<ScopeHistory> m_Scopes;
+
+public:
+  ProfilerPanel();
+
+  /* GL thread, between NewFrame and Render */
+  void Draw();
+
+private:
+  void Consume(const ProfileFrame& frame);
+  void DrawTimeline();
+  void DrawHistogram(const char* label, const std::vector<float>& ms);
+};
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "RenderCommandBuffer.h"
+
+#include <cstring>
+
+#include "Profiler.h"
+
+RenderCommandBuffer::RenderCommandBuffer()
+    : m_Allocator(256 * 1024)
+{
+}
+
+RenderCommand& RenderCommandBuffer::Draw(Shader& shader,
+    const VertexArray& va, const IndexBuffer& ib, float depth /*= 0.0f */)
+{
+  return DrawInstanced(shader, va, ib, 0, depth);
+}
+
+RenderCommand& RenderCommandBuffer::DrawInstanced(Shader& shader,
+    const VertexArray& va, const IndexBuffer& ib, unsigned int instances,
+    float depth /*= 0.0f */)
+{
+  RenderCommand* command = m_Allocator.New<RenderCommand>();
+  *command = { &shader, &va, &ib, ib.GetCount(), instances, depth, {},
+    nullptr };
+  m_Commands.push_back(command);
+  return *command;
+}
+
+void RenderCommandBuffer::SetTexture(
+    RenderCommand& command, unsigned int slot, const Texture& texture)
+{
+  ASSERT(slot < RenderCommand::MaxTextures);
+  command.Textures[slot] = &texture;
+}
+
+void RenderCommandBuffer::SetUniform(
+    RenderCommand& command, Uniform name, int value)
+{
+  AddUniform(command, name, CommandUniform::Type::Int).Int = value;
+}
+
+void RenderCommandBuffer::SetUniform(
+    RenderCommand& command, Uniform name, float value)
+{
+  AddUniform(command, name, CommandUniform::Type::Float).Float = value;
+}
+
+void RenderCommandBuffer::SetUniform(
+    RenderCommand& command, Uniform name, const glm::vec4& value)
+{
+  memcpy(AddUniform(command, name, CommandUniform::Type::Vec4).Vec4, &value[0],
+      sizeof(float) * 4);
+}
+
+void RenderCommandBuffer::SetUniform(
+    RenderCommand& command, Uniform name, const glm::mat4& value)
+{
+  memcpy(AddUniform(command, name, CommandUniform::Type::Mat4).Mat4,
+      &value[0][0], sizeof(float) * 16);
+}
+
+void RenderCommandBuffer::Reset()
+{
+  m_Commands.clear();
+  m_Allocator.Reset();
+}
+
+uint64_t RenderCommandBuffer::SortKey(const RenderCommand& command)
+{
+  // flip floats so they order like unsigned ints: negatives reversed, sign
+  // bit set on the positives
+  uint32_t depth;
+  memcpy(&depth, &command.Depth, sizeof(depth));
+  depth ^= (depth & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+
+  uint64_t program = command.Program->GetRendererID() & 0xFFFF;
+  uint64_t texture
+      = command.Textures[0] ? command.Textures[0]->GetRendererID() & 0xFFFF : 0;
+  return program << 48 | texture << 32 | depth;
+}
+
+void RenderCommandBuffer::Record(ThreadPool& pool,
+    std::vector<RenderCommandBuffer>& buffers, unsigned int count,
+    const std::function<void(RenderCommandBuffer&, unsigned int begin,
+        unsigned int end)>& record)
+{
+  // the jobs only capture an index and a pointer, which std::function keeps
+  // inline, so submitting them every frame doesn't allocate
+  struct Shared
+  {
+    std::vector<RenderCommandBuffer>& Buffers;
+    uint64_t Count;
+    const std::function<void(RenderCommandBuffer&, unsigned int,
+        unsigned int)>& Record;
+  } shared = { buffers, count, record };
+  const unsigned int jobs = buffers.size();
+  for (unsigned int job = 0; job < jobs; job++)
+  {
+    pool.Submit([job, &shared] {
+      PROFILE_SCOPE("Record");
+      const uint64_t total = shared.Buffers.size();
+      unsigned int begin = (unsigned int)(shared.Count * job / total);
+      unsigned int end = (unsigned int)(shared.Count * (job + 1) / total);
+      shared.Record(shared.Buffers[job], begin, end);
+    });
+  }
+  pool.Wait();
+}
+
+CommandUniform& RenderCommandBuffer::AddUniform(
+    RenderCommand& command, Uniform name, CommandUniform::Type type)
+{
+  // prepended, so they're set in reverse order, which doesn't matter
+  CommandUniform* uniform
+      = m_Allocator.New<CommandUniform>(command.Uniforms, name, type);
+  command.Uniforms = uniform;
+  return *uniform;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "IndexBuffer.h"
+#include "LinearAllocator.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+
+/* A uniform to set right before the draw, resolved on the GL thread */
+struct CommandUniform
+{
+  enum class Type
+  {
+    Int,
+    Float,
+    Vec4,
+    Mat4
+  };
+
+  CommandUniform* Next;
+  Uniform Name;
+  Type Kind;
+  union
+  {
+    int Int;
+    float Float;
+    float Vec4[4];
+    float Mat4[16];
+  };
+};
+
+/* Everything one draw needs, recorded without touching GL */
+struct RenderCommand
+{
+  static const unsigned int MaxTextures = 4;
+
+  Shader* Program;
+  const VertexArray* Array;
+  const IndexBuffer* Indices;
+  unsigned int Count;     // indices to draw, all of them by default
+  unsigned int Instances; // 0 for a plain glDrawElements
+  float Depth;            // sorts front to back within a program/texture
+  const Texture* Textures[MaxTextures];
+  CommandUniform* Uniforms;
+};
+
+/*
+ * Draws recorded on any thread, submitted on the GL one. Each buffer owns a
+ * LinearAllocator, so one buffer per worker records without locking, and
+ * everything it recorded goes away in one Reset() once the frame is
+ * submitted. Renderer::Submit() merges any number of buffers, sorts by
+ * SortKey() and replays through GLState, so runs of the same program and
+ * texture cost one bind.
+ *
+ *   RenderCommand& draw = commands.Draw(shader, va, ib);
+ *   commands.SetTexture(draw, 0, texture);
+ *   commands.SetUniform(draw, "u_Model", model);
+ */
+class RenderCommandBuffer
+{
+private:
+  LinearAllocator m_Allocator;
+  std::vector<RenderCommand*> m_Commands;
+
+public:
+  RenderCommandBuffer();
+
+  RenderCommand& Draw(Shader& shader, const VertexArray& va,
+      const IndexBuffer& ib, float depth = 0.0f);
+  RenderCommand& DrawInstanced(Shader& shader, const VertexArray& va,
+      const IndexBuffer& ib, unsigned int instances, float depth = 0.0f);
+
+  void SetTexture(
+      RenderCommand& command, unsigned int slot, const Texture& texture);
+  void SetUniform(RenderCommand& command, Uniform name, int value);
+  void SetUniform(RenderCommand& command, Uniform name, float value);
+  void SetUniform(RenderCommand& command, Uniform name, const glm::vec4& value);
+  void SetUniform(RenderCommand& command, Uniform name, const glm::mat4& value);
+
+  /* forgets every command, keeps the memory */
+  void Reset();
+
+  inline const std::vector<RenderCommand*>& GetCommands() const
+  {
+    return m_Commands;
+  }
+  inline size_t GetMemoryUsed() const { return m_Allocator.GetUsed(); }
+
+  /* bits 63-48 program, 47-32 first texture, 31-0 depth (front to back) */
+  static uint64_t SortKey(const RenderCommand& command);
+
+  /* Splits [0, count) into one range per buffer and records each range into
+     its buffer on `pool`, returns when they're all done */
+  static void Record(ThreadPool& pool,
+      std::vector<RenderCommandBuffer>& buffers, unsigned int count,
+      const std::function<void(RenderCommandBuffer&, unsigned int begin,
+          unsigned int end)>& record);
+
+private:
+  CommandUniform& AddUniform(
+      RenderCommand& command, Uniform name, CommandUniform::Type type);
+};
\ No newline at end of file
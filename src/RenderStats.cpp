@@ -0,0 +1,7 @@
+#include "RenderStats.h"
+
+RenderStats& RenderStats::Get()
+{
+  static RenderStats stats;
+  return stats;
+}
\ No newline at end of file
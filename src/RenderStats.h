@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * Per-frame counters everything that talks to GL bumps. Reset() once at the
+ * top of the frame, read them after the last draw.
+ */
+struct RenderStats
+{
+  unsigned int DrawCalls = 0;
+  unsigned int StateChanges = 0;        // issued to the driver
+  unsigned int StateChangesSkipped = 0; // filtered out by GLState
+  double FenceWaitMs = 0.0; // CPU blocked on streaming buffer fences
+
+  static RenderStats& Get();
+  static void Reset() { Get() = RenderStats(); }
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+
+RenderTargetPool::RenderTargetPool()
+    : m_Targets(32)
+    , m_Frame(0)
+{
+  // a scene, a pyramid up and down and some slack, before anything grows
+  m_Entries.reserve(32);
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+  // the Pool only frees memory, the GL objects go here
+  for (const Entry& entry : m_Entries)
+    m_Targets.Delete(entry.Target);
+}
+
+Framebuffer* RenderTargetPool::Acquire(const FramebufferSpec& spec)
+{
+  m_Stats.Acquired++;
+  for (Entry& entry : m_Entries)
+    if (!entry.InUse && entry.Target->GetSpec() == spec)
+    {
+      entry.InUse = true;
+      entry.LastUsed = m_Frame;
+      return entry.Target;
+    }
+
+  Framebuffer* target = m_Targets.New(spec);
+  m_Entries.push_back({ target, true, m_Frame });
+  m_Stats.Created++;
+  m_Stats.Targets++;
+  m_Stats.Bytes += target->GetByteSize();
+  return target;
+}
+
+void RenderTargetPool::Release(const Framebuffer* target)
+{
+  for (Entry& entry : m_Entries)
+    if (entry.Target == target)
+    {
+      ASSERT(entry.InUse);
+      entry.InUse = false;
+      return;
+    }
+  ASSERT(false); // not one of ours
+}
+
+void RenderTargetPool::EndFrame()
+{
+  auto unused = [&](const Entry& entry) {
+    return !entry.InUse && entry.LastUsed < m_Frame;
+  };
+  for (const Entry& entry : m_Entries)
+    if (unused(entry))
+    {
+      m_Stats.Targets--;
+      m_Stats.Bytes -= entry.Target->GetByteSize();
+      m_Targets.Delete(entry.Target);
+    }
+  m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), unused),
+      m_Entries.end());
+  m_Frame++;
+}
+
+void RenderTargetPool::ResetStats()
+{
+  m_Stats.Created = 0;
+  m_Stats.Acquired = 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Framebuffer.h"
+#include "Pool.h"
+
+struct RenderTargetStats
+{
+  unsigned int Targets = 0;  // alive, in use or not
+  unsigned int Created = 0;  // since the last ResetStats()
+  unsigned int Acquired = 0; // same
+  size_t Bytes = 0;          // every alive target's attachments
+};
+
+/*
+ * Framebuffers handed out by spec for the length of a pass or two. Release()
+ * only puts a target back on the shelf, and the next Acquire() of the same
+ * size and format gets that one again, so passes that don't overlap in time
+ * alias the same memory and a frame that looks like the last one creates
+ * nothing. Whatever sat unused through a whole frame is deleted by
+ * EndFrame(), so a resize or a settings change doesn't leak the old sizes.
+ * The Framebuffer handles themselves live in a Pool, so that churn doesn't
+ * go to the heap either.
+ */
+class RenderTargetPool
+{
+private:
+  struct Entry
+  {
+    Framebuffer* Target; // in m_Targets
+    bool InUse;
+    uint64_t LastUsed; // frame
+  };
+
+  Pool<Framebuffer> m_Targets;
+  std::vector<Entry> m_Entries;
+  uint64_t m_Frame;
+  RenderTargetStats m_Stats;
+
+public:
+  RenderTargetPool();
+  ~RenderTargetPool();
+
+  RenderTargetPool(const RenderTargetPool&) = delete;
+  RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+  Framebuffer* Acquire(const FramebufferSpec& spec);
+  void Release(const Framebuffer* target);
+  void EndFrame();
+
+  inline const RenderTargetStats& GetStats() const { return m_Stats; }
+  void ResetStats();
+};
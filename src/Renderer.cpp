@@ -1,14 +1,95 @@
 #include "Renderer.h"
 
+#include <algorithm>
+
+#include "Profiler.h"
+
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const
 {
     shader.Bind();
     va.Bind();
     ib.Bind();
-    GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+    GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr));
+    RenderStats::Get().DrawCalls++;
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib,
+    const Shader& shader, unsigned int instances) const
+{
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+    GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), ib.GetType(),
+        nullptr, instances));
+    RenderStats::Get().DrawCalls++;
+}
+
+void Renderer::Submit(RenderCommandBuffer* const* buffers, unsigned int count)
+{
+    PROFILE_SCOPE("Submit");
+    m_Queue.clear();
+    for (unsigned int i = 0; i < count; i++)
+        for (const RenderCommand* command : buffers[i]->GetCommands())
+            m_Queue.push_back({ RenderCommandBuffer::SortKey(*command),
+                (uint32_t)m_Queue.size(), command });
+
+    // equal keys keep the order they were recorded in, or blended sprites
+    // sharing a program and texture could swap from one frame to the next.
+    // Not std::stable_sort, which allocates a buffer every call.
+    std::sort(m_Queue.begin(), m_Queue.end(),
+            [](const SortedCommand& a, const SortedCommand& b) {
+                return a.Key != b.Key ? a.Key < b.Key
+                                      : a.Sequence < b.Sequence;
+            });
+
+    for (const SortedCommand& sorted : m_Queue)
+        Execute(*sorted.Command);
+}
+
+void Renderer::Execute(const RenderCommand& command) const
+{
+    // GLState drops whatever the previous command already bound
+    Shader& shader = *command.Program;
+    shader.Bind();
+    for (unsigned int slot = 0; slot < RenderCommand::MaxTextures; slot++)
+        if (command.Textures[slot]) command.Textures[slot]->Bind(slot);
+    command.Array->Bind();
+    command.Indices->Bind();
+
+    for (const CommandUniform* u = command.Uniforms; u; u = u->Next)
+    {
+        int location = shader.GetUniformLocation(u->Name);
+        switch (u->Kind)
+        {
+        case CommandUniform::Type::Int:
+            GLCall(glUniform1i(location, u->Int));
+            break;
+        case CommandUniform::Type::Float:
+            GLCall(glUniform1f(location, u->Float));
+            break;
+        case CommandUniform::Type::Vec4:
+            GLCall(glUniform4fv(location, 1, u->Vec4));
+            break;
+        case CommandUniform::Type::Mat4:
+            GLCall(glUniformMatrix4fv(location, 1, GL_FALSE, u->Mat4));
+            break;
+        }
+    }
+
+    if (command.Instances)
+    {
+        GLCall(glDrawElementsInstanced(GL_TRIANGLES, command.Count,
+                command.Indices->GetType(), nullptr, command.Instances));
+    }
+    else
+    {
+        GLCall(glDrawElements(GL_TRIANGLES, command.Count,
+                command.Indices->GetType(), nullptr));
+    }
+    RenderStats::Get().DrawCalls++;
 }
 
 void Renderer::Clear() const
 {
-    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 }
\ No newline at end of file
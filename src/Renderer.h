@@ -2,9 +2,13 @@
 
 #include <iostream>
 
+#include <cstdint>
+#include <vector>
+
 #include "Assert.h"
 #include "VertexArray.h"
 #include "IndexBuffer.h"
+#include "RenderCommandBuffer.h"
 #include "Shader.h"
 
 
@@ -12,5 +16,23 @@ class Renderer
 {
 public:
   void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+  /* the whole index buffer, `instances` times, in one call */
+  void DrawInstanced(const VertexArray& va, const IndexBuffer& ib,
+      const Shader& shader, unsigned int instances) const;
   void Clear() const;
+
+  /* Sorts every command in `buffers` by RenderCommandBuffer::SortKey and
+     draws them, binding only what changes. GL thread only. */
+  void Submit(RenderCommandBuffer* const* buffers, unsigned int count);
+
+private:
+  struct SortedCommand
+  {
+    uint64_t Key;
+    uint32_t Sequence; // submission order, breaks ties between equal keys
+    const RenderCommand* Command;
+  };
+  std::vector<SortedCommand> m_Queue; // kept around so it doesn't reallocate
+
+  void Execute(const RenderCommand& command) const;
 };
\ No newline at end of file
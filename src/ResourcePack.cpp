@@ -0,0 +1,218 @@
+#include "ResourcePack.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static const uint32_t PackMagic = 0x504c474f; // "OGLP"
+static const uint32_t PackVersion = 1;
+static const uint64_t PackAlignment = 64;
+
+struct PackHeader
+{
+  uint32_t Magic, Version, EntryCount, Reserved;
+  uint64_t TocOffset, NamesOffset;
+};
+
+static std::unique_ptr<ResourcePack> s_Mounted;
+static std::string s_Root;
+
+/* 64-bit FNV-1a, names and contents alike */
+static uint64_t Hash64(const void* data, size_t size)
+{
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+static uint64_t AlignUp(uint64_t value)
+{
+  return (value + PackAlignment - 1) & ~(PackAlignment - 1);
+}
+
+ResourcePack::ResourcePack()
+    : m_Entries(nullptr)
+    , m_EntryCount(0)
+    , m_Names(nullptr)
+{
+}
+
+bool ResourcePack::Open(const std::string& filepath)
+{
+  m_EntryCount = 0;
+  if (!m_File.Open(filepath) || m_File.GetSize() < sizeof(PackHeader))
+    return false;
+
+  const unsigned char* data = m_File.GetData();
+  const size_t size = m_File.GetSize();
+  const auto* header = (const PackHeader*)data;
+  if (header->Magic != PackMagic || header->Version != PackVersion
+      || header->TocOffset % alignof(Entry) != 0
+      || header->TocOffset + (uint64_t)header->EntryCount * sizeof(Entry)
+             > size
+      || header->NamesOffset > size)
+    return false;
+
+  const auto* entries = (const Entry*)(data + header->TocOffset);
+  for (uint32_t i = 0; i < header->EntryCount; i++)
+    if (entries[i].Offset + entries[i].Size > size
+        || header->NamesOffset + entries[i].NameOffset
+                   + entries[i].NameLength
+               > size)
+      return false;
+
+  m_Entries = entries;
+  m_Names = (const char*)data + header->NamesOffset;
+  m_EntryCount = header->EntryCount;
+  return true;
+}
+
+std::span<const unsigned char> ResourcePack::Find(std::string_view name) const
+{
+  const uint64_t hash = Hash64(name.data(), name.size());
+  const Entry* end = m_Entries + m_EntryCount;
+  const Entry* entry = std::lower_bound(m_Entries, end, hash,
+      [](const Entry& a, uint64_t b) { return a.NameHash < b; });
+  for (; entry != end && entry->NameHash == hash; entry++)
+  {
+    std::string_view entryName(m_Names + entry->NameOffset, entry->NameLength);
+    if (entryName == name)
+      return { m_File.GetData() + entry->Offset, (size_t)entry->Size };
+  }
+  return {};
+}
+
+bool ResourcePack::Verify() const
+{
+  for (unsigned int i = 0; i < m_EntryCount; i++)
+  {
+    const Entry& entry = m_Entries[i];
+    if (Hash64(m_File.GetData() + entry.Offset, entry.Size)
+        != entry.ContentHash)
+      return false;
+  }
+  return true;
+}
+
+bool ResourcePack::Write(
+    const std::string& filepath, const std::string& directory)
+{
+  struct File
+  {
+    std::string Name;
+    std::vector<char> Data;
+  };
+  std::vector<File> files;
+  // one error code per call, so a later one can't hide an earlier one
+  std::error_code resolving;
+  const std::filesystem::path output
+      = std::filesystem::weakly_canonical(filepath, resolving);
+  if (resolving) return false;
+  std::error_code iterating;
+  std::filesystem::recursive_directory_iterator item(directory, iterating);
+  for (; !iterating && item != std::filesystem::recursive_directory_iterator();
+       item.increment(iterating))
+  {
+    std::error_code status;
+    const bool regular = item->is_regular_file(status);
+    if (status) return false;
+    if (!regular) continue;
+    std::error_code canonical;
+    const std::filesystem::path path
+        = std::filesystem::weakly_canonical(item->path(), canonical);
+    if (canonical) return false;
+    if (path == output) continue;
+
+    std::ifstream in(item->path(), std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    File file;
+    std::error_code relative;
+    file.Name = std::filesystem::relative(item->path(), directory, relative)
+                    .generic_string();
+    if (relative) return false;
+    file.Data.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read(file.Data.data(), file.Data.size());
+    files.push_back(std::move(file));
+  }
+  if (iterating) return false;
+  // directory order isn't stable, sort so the same tree packs the same
+  std::sort(files.begin(), files.end(),
+      [](const File& a, const File& b) { return a.Name < b.Name; });
+
+  std::vector<Entry> entries(files.size());
+  std::string names;
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    const File& file = files[i];
+    entries[i] = { Hash64(file.Name.data(), file.Name.size()),
+      Hash64(file.Data.data(), file.Data.size()), 0, file.Data.size(),
+      (uint32_t)names.size(), (uint32_t)file.Name.size() };
+    names += file.Name;
+    names.push_back('\0');
+  }
+
+  PackHeader header = { PackMagic, PackVersion, (uint32_t)files.size(), 0,
+    AlignUp(sizeof(PackHeader)), 0 };
+  header.NamesOffset = header.TocOffset + entries.size() * sizeof(Entry);
+  uint64_t offset = AlignUp(header.NamesOffset + names.size());
+  for (Entry& entry : entries)
+  {
+    entry.Offset = offset;
+    offset = AlignUp(offset + entry.Size);
+  }
+
+  // the table is sorted by name hash for Find(), the data stays in name
+  // order, which is how it was laid out above
+  std::vector<size_t> order(files.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return entries[a].NameHash < entries[b].NameHash;
+  });
+
+  std::ofstream out(filepath, std::ios::binary);
+  if (!out) return false;
+  auto pad = [&](uint64_t to) {
+    while ((uint64_t)out.tellp() < to)
+      out.put(0);
+  };
+  out.write((const char*)&header, sizeof(header));
+  pad(header.TocOffset);
+  for (size_t i : order)
+    out.write((const char*)&entries[i], sizeof(Entry));
+  out.write(names.data(), names.size());
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    pad(entries[i].Offset);
+    out.write(files[i].Data.data(), files[i].Data.size());
+  }
+  return (bool)out;
+}
+
+bool ResourcePack::Mount(const std::string& filepath, const std::string& root)
+{
+  auto pack = std::make_unique<ResourcePack>();
+  if (!pack->Open(filepath)) return false;
+  s_Mounted = std::move(pack);
+  s_Root = root;
+  return true;
+}
+
+void ResourcePack::Unmount()
+{
+  s_Mounted.reset();
+  s_Root.clear();
+}
+
+std::span<const unsigned char> ResourcePack::Lookup(std::string_view path)
+{
+  if (!s_Mounted || !path.starts_with(s_Root)) return {};
+  return s_Mounted->Find(path.substr(s_Root.size()));
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "MappedFile.h"
+
+/*
+ * Every file under a directory in one archive (respack writes them, see
+ * Write()), mapped whole and read in place. Find() is a binary search over
+ * the table of contents and hands back a view into the mapping, so there's
+ * one open for the lot and no copies.
+ *
+ *   "OGLP" version entryCount 0 tocOffset namesOffset
+ *   entryCount x { nameHash contentHash offset size nameOffset nameLength },
+ *     sorted by nameHash
+ *   names, then the data, every entry 64 byte aligned
+ *
+ * Names are paths relative to the packed directory with / separators,
+ * e.g. "shaders/basic.shader".
+ */
+class ResourcePack
+{
+public:
+  struct Entry
+  {
+    uint64_t NameHash;
+    uint64_t ContentHash;
+    uint64_t Offset;
+    uint64_t Size;
+    uint32_t NameOffset, NameLength;
+  };
+
+private:
+  MappedFile m_File;
+  const Entry* m_Entries;
+  unsigned int m_EntryCount;
+  const char* m_Names;
+
+public:
+  ResourcePack();
+
+  bool Open(const std::string& filepath);
+
+  /* empty if it's not in the pack; valid as long as the pack is open */
+  std::span<const unsigned char> Find(std::string_view name) const;
+  /* rehashes every entry against its content hash, slow */
+  bool Verify() const;
+
+  inline unsigned int GetEntryCount() const { return m_EntryCount; }
+  inline size_t GetSize() const { return m_File.GetSize(); }
+
+  /* packs every file under `directory` into `filepath` */
+  static bool Write(const std::string& filepath, const std::string& directory);
+
+  /*
+   * The pack Shader and Texture look in before going to disk. A path that
+   * starts with `root` is looked up without it, so with
+   *
+   *   ResourcePack::Mount("res.pack", "../res/");
+   *
+   * "../res/shaders/basic.shader" comes out of the pack as
+   * "shaders/basic.shader" and anything not in there still loads loose.
+   * Mount before anything loads; lookups don't lock.
+   */
+  static bool Mount(const std::string& filepath, const std::string& root);
+  static void Unmount();
+  static std::span<const unsigned char> Lookup(std::string_view path);
+};
@@ -1,77 +1,345 @@
 #include "Shader.h"
 
+#include <string_view>
+#include <unordered_map>
+
+#include "ResourcePack.h"
+#include "ShaderWatcher.h"
+
 Shader::Shader(const std::string& filepath)
     : m_FilePath(filepath)
     , m_RendererID(0)
 {
-  ShaderProgramSource source = ParseShader();
+  // straight out of the mapping when there's a pack, from disk otherwise
+  std::span<const unsigned char> packed = ResourcePack::Lookup(m_FilePath);
+  ShaderProgramSource source;
+  if (packed.empty())
+    source = ParseShader(m_FilePath);
+  else
+    source = ParseShaderSource(
+        std::string_view((const char*)packed.data(), packed.size()));
   m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+  m_Uniforms.Build(m_RendererID);
+  BindKnownUniformBlocks();
+  ShaderWatcher::Watch(this);
 }
 
-Shader::~Shader() { GLCall(glDeleteProgram(m_RendererID)); }
+Shader::~Shader()
+{
+  ShaderWatcher::Unwatch(this);
+  DropPending();
+  GLState::ForgetProgram(m_RendererID);
+  GLCall(glDeleteProgram(m_RendererID));
+}
 
-void Shader::Bind() const { GLCall(glUseProgram(m_RendererID)); }
+void Shader::Bind() const { GLState::UseProgram(m_RendererID); }
 
-void Shader::Unbind() const { GLCall(glUseProgram(0)); }
+void Shader::Unbind() const { GLState::UseProgram(0); }
 
-void Shader::SetUniform4f(
-    const std::string& name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform4f(Uniform name, float v0, float v1, float v2, float v3)
 {
   GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
 }
 
-void Shader::SetUniform1i(const std::string& name, int v0)
+void Shader::SetUniform1i(Uniform name, int v0)
 {
   GLCall(glUniform1i(GetUniformLocation(name), v0));
 }
 
-void Shader::SetUniform1f(const std::string& name, float v0)
+void Shader::SetUniform1iv(Uniform name, int count, const int* values)
+{
+  GLCall(glUniform1iv(GetUniformLocation(name), count, values));
+}
+
+void Shader::SetUniform1f(Uniform name, float v0)
 {
   GLCall(glUniform1f(GetUniformLocation(name), v0));
 }
 
-void Shader::SetUniformMat4f(const std::string& name, glm::mat4& matrix)
+void Shader::SetUniformMat4f(Uniform name, const glm::mat4& matrix)
 {
   // number of matrices=1, transpose=GL_FALSE,
   GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
-int Shader::GetUniformLocation(const std::string& name)
+void Shader::BindUniformBlock(const std::string& name, UniformBinding binding)
 {
-  if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-    return m_UniformLocationCache[name];
+  GLCall(unsigned int index = glGetUniformBlockIndex(m_RendererID, name.c_str()));
+  if (index == GL_INVALID_INDEX)
+  {
+    std::cout << "Warning: uniform block '" << name << "' doesn't exist!"
+              << std::endl;
+    return;
+  }
+  GLCall(glUniformBlockBinding(m_RendererID, index, (unsigned int)binding));
+}
 
-  GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-  if (location == -1)
-    std::cout << "Warning: uniform '" << name << "' doesn't exist!"
+void Shader::BindKnownUniformBlocks()
+{
+  int count = 0;
+  GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+  for (int i = 0; i < count; i++)
+  {
+    char name[64];
+    GLCall(glGetActiveUniformBlockName(
+        m_RendererID, i, sizeof(name), nullptr, name));
+    for (const UniformBlockName& block : UniformBlocks)
+    {
+      if (strcmp(name, block.Name) != 0) continue;
+      GLCall(glUniformBlockBinding(m_RendererID, i, (unsigned int)block.Binding));
+    }
+  }
+}
+
+void Shader::Reload(const ShaderProgramSource& source)
+{
+  DropPending();
+  m_Pending.Key = ShaderCache::Key(source.VertexSource, source.FragmentSource);
+  // seen this source before, it's already linked
+  m_Pending.Program = ShaderCache::Load(m_Pending.Key);
+  if (m_Pending.Program) return;
+
+  // with KHR_parallel_shader_compile none of this waits on the compiler,
+  // the first status query does, which UpdateReload holds off on
+  GLCall(m_Pending.Program = glCreateProgram());
+  m_Pending.Vertex = SubmitShader(GL_VERTEX_SHADER, source.VertexSource);
+  m_Pending.Fragment = SubmitShader(GL_FRAGMENT_SHADER, source.FragmentSource);
+  GLCall(glAttachShader(m_Pending.Program, m_Pending.Vertex));
+  GLCall(glAttachShader(m_Pending.Program, m_Pending.Fragment));
+  if (ShaderCache::IsSupported())
+  {
+    GLCall(glProgramParameteri(
+        m_Pending.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+  }
+  GLCall(glLinkProgram(m_Pending.Program));
+}
+
+bool Shader::UpdateReload()
+{
+  if (!m_Pending.Program) return false;
+
+  if (GLEW_KHR_parallel_shader_compile)
+  {
+    int done = GL_FALSE;
+    GLCall(glGetProgramiv(m_Pending.Program, GL_COMPLETION_STATUS_KHR, &done));
+    if (done == GL_FALSE) return false;
+  }
+
+  // a binary from the cache has no shader objects, it's linked already
+  bool fromCache = m_Pending.Vertex == 0;
+  bool built = fromCache
+               || (CheckCompileStatus(m_Pending.Vertex, GL_VERTEX_SHADER)
+                   && CheckCompileStatus(m_Pending.Fragment, GL_FRAGMENT_SHADER)
+                   && CheckLinkStatus(m_Pending.Program));
+  if (!built)
+  {
+    std::cerr << "Keeping the last good program for " << m_FilePath
               << std::endl;
+    DropPending();
+    return true;
+  }
+
+  if (!fromCache) ShaderCache::Store(m_Pending.Key, m_Pending.Program);
+  unsigned int program = m_Pending.Program;
+  m_Pending.Program = 0;
+  DropPending();
+  SwapProgram(program);
+  return true;
+}
+
+void Shader::SwapProgram(unsigned int program)
+{
+  // whatever was set once and left alone (samplers, mostly) has to survive
+  CopyUniforms(m_RendererID, program);
+  CopyUniformBlockBindings(m_RendererID, program);
+
+  GLState::ForgetProgram(m_RendererID);
+  GLCall(glDeleteProgram(m_RendererID));
+  m_RendererID = program;
+  // locations are per program, the old table is meaningless now
+  m_Uniforms.Build(m_RendererID);
+  BindKnownUniformBlocks();
+}
+
+/* Copies every default block uniform the new program shares with the old
+   one, matched by name and type */
+void Shader::CopyUniforms(unsigned int from, unsigned int to)
+{
+  auto forEachUniform = [](unsigned int program, auto&& visit) {
+    int count = 0;
+    GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count));
+    for (int i = 0; i < count; i++)
+    {
+      char name[128];
+      int length = 0, size = 0;
+      unsigned int type = 0;
+      GLCall(glGetActiveUniform(
+          program, i, sizeof(name), &length, &size, &type, name));
+      std::string base(name, length);
+      if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+        base.resize(base.size() - 3);
+      for (int element = 0; element < size; element++)
+        visit(size > 1 ? base + "[" + std::to_string(element) + "]" : base,
+            type);
+    }
+  };
+
+  std::unordered_map<std::string, unsigned int> types;
+  forEachUniform(from, [&](const std::string& name, unsigned int type) {
+    types[name] = type;
+  });
+
+  GLState::UseProgram(to);
+  forEachUniform(to, [&](const std::string& name, unsigned int type) {
+    auto old = types.find(name);
+    if (old == types.end() || old->second != type) return;
+    GLCall(int source = glGetUniformLocation(from, name.c_str()));
+    GLCall(int destination = glGetUniformLocation(to, name.c_str()));
+    if (source == -1 || destination == -1) return; // in a block
+
+    float f[16];
+    int i[4];
+    unsigned int u[4];
+    switch (type)
+    {
+    case GL_FLOAT:
+      GLCall(glGetUniformfv(from, source, f));
+      GLCall(glUniform1fv(destination, 1, f));
+      break;
+    case GL_FLOAT_VEC2:
+      GLCall(glGetUniformfv(from, source, f));
+      GLCall(glUniform2fv(destination, 1, f));
+      break;
+    case GL_FLOAT_VEC3:
+      GLCall(glGetUniformfv(from, source, f));
+      GLCall(glUniform3fv(destination, 1, f));
+      break;
+    case GL_FLOAT_VEC4:
+      GLCall(glGetUniformfv(from, source, f));
+      GLCall(glUniform4fv(destination, 1, f));
+      break;
+    case GL_FLOAT_MAT3:
+      GLCall(glGetUniformfv(from, source, f));
+      GLCall(glUniformMatrix3fv(destination, 1, GL_FALSE, f));
+      break;
+    case GL_FLOAT_MAT4:
+      GLCall(glGetUniformfv(from, source, f));
+      GLCall(glUniformMatrix4fv(destination, 1, GL_FALSE, f));
+      break;
+    case GL_UNSIGNED_INT:
+      GLCall(glGetUniformuiv(from, source, u));
+      GLCall(glUniform1uiv(destination, 1, u));
+      break;
+    case GL_INT_VEC2:
+      GLCall(glGetUniformiv(from, source, i));
+      GLCall(glUniform2iv(destination, 1, i));
+      break;
+    case GL_INT_VEC3:
+      GLCall(glGetUniformiv(from, source, i));
+      GLCall(glUniform3iv(destination, 1, i));
+      break;
+    case GL_INT_VEC4:
+      GLCall(glGetUniformiv(from, source, i));
+      GLCall(glUniform4iv(destination, 1, i));
+      break;
+    case GL_FLOAT_MAT2:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC4:
+    case GL_BOOL_VEC2:
+    case GL_BOOL_VEC3:
+    case GL_BOOL_VEC4:
+      break; // nothing uses these yet
+    default:
+      // int, bool and every sampler type are a single int
+      GLCall(glGetUniformiv(from, source, i));
+      GLCall(glUniform1iv(destination, 1, i));
+      break;
+    }
+  });
+}
+
+/* Keeps bindings made through BindUniformBlock by hand */
+void Shader::CopyUniformBlockBindings(unsigned int from, unsigned int to)
+{
+  int count = 0;
+  GLCall(glGetProgramiv(to, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+  for (int i = 0; i < count; i++)
+  {
+    char name[64];
+    GLCall(glGetActiveUniformBlockName(to, i, sizeof(name), nullptr, name));
+    GLCall(unsigned int old = glGetUniformBlockIndex(from, name));
+    if (old == GL_INVALID_INDEX) continue;
+    int binding = 0;
+    GLCall(glGetActiveUniformBlockiv(
+        from, old, GL_UNIFORM_BLOCK_BINDING, &binding));
+    GLCall(glUniformBlockBinding(to, i, binding));
+  }
+}
 
-  // if it stores -1 doesn't that become a problem when we do want to set it?
-  m_UniformLocationCache[name] = location;
-  return location;
+void Shader::DropPending()
+{
+  // shaders are only flagged for deletion while they're still attached
+  if (m_Pending.Vertex)
+  {
+    GLCall(glDeleteShader(m_Pending.Vertex));
+  }
+  if (m_Pending.Fragment)
+  {
+    GLCall(glDeleteShader(m_Pending.Fragment));
+  }
+  if (m_Pending.Program)
+  {
+    GLCall(glDeleteProgram(m_Pending.Program));
+  }
+  m_Pending = {};
 }
 
 unsigned int Shader::CreateShader(
     const std::string& vertex_shader, const std::string& fragment_shader)
 {
+  const uint64_t key = ShaderCache::Key(vertex_shader, fragment_shader);
+  if (unsigned int program = ShaderCache::Load(key)) return program;
+
   GLCall(unsigned int program = glCreateProgram());
   unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertex_shader);
   unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragment_shader);
   GLCall(glAttachShader(program, vs));
   GLCall(glAttachShader(program, fs));
+  if (ShaderCache::IsSupported())
+  {
+    GLCall(glProgramParameteri(
+        program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+  }
   GLCall(glLinkProgram(program));
   GLCall(glValidateProgram(program));
 
   GLCall(glDeleteShader(vs));
   GLCall(glDeleteShader(fs));
 
+  int linked = GL_FALSE;
+  GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+  if (linked == GL_TRUE) ShaderCache::Store(key, program);
+
   return program;
 }
 
-ShaderProgramSource Shader::ParseShader()
+ShaderProgramSource Shader::ParseShader(const std::string& filepath)
 {
-  std::ifstream stream(m_FilePath);
+  // the whole file in one read, then split on the #shader lines in place
+  std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+  std::string file;
+  if (stream)
+  {
+    file.resize((size_t)stream.tellg());
+    stream.seekg(0);
+    stream.read(file.data(), file.size());
+  }
+  return ParseShaderSource(file);
+}
 
+ShaderProgramSource Shader::ParseShaderSource(std::string_view file)
+{
   enum class ShaderType
   {
     NONE = -1,
@@ -79,51 +347,85 @@ ShaderProgramSource Shader::ParseShader()
     FRAGMENT = 1
   };
 
-  std::string line;
-  std::stringstream ss[2];
+  ShaderProgramSource source;
+  std::string* sources[2] = { &source.VertexSource, &source.FragmentSource };
   ShaderType type = ShaderType::NONE;
-  while (getline(stream, line))
+  std::string_view rest = file;
+  while (!rest.empty())
   {
-    if (line.find("#shader") != std::string::npos)
+    size_t end = rest.find('\n');
+    std::string_view line = rest.substr(0, end);
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+    if (line.find("#shader") != std::string_view::npos)
     {
-      if (line.find("vertex") != std::string::npos)
+      if (line.find("vertex") != std::string_view::npos)
         type = ShaderType::VERTEX;
-      else if (line.find("fragment") != std::string::npos)
+      else if (line.find("fragment") != std::string_view::npos)
         type = ShaderType::FRAGMENT;
     }
-    else
-      ss[(int)type] << line << std::endl;
+    else if (type != ShaderType::NONE)
+    {
+      sources[(int)type]->append(line);
+      sources[(int)type]->push_back('\n');
+    }
   }
-
-  return { ss[0].str(), ss[1].str() };
+  return source;
 }
 
 /* Compiles a shader, `source`,  of type `type` and returns the id */
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 {
-  GLCall(unsigned int id = glCreateShader(type));
-  const char* src = source.c_str();
-  GLCall(glShaderSource(id, 1, &src, 0));
-  GLCall(glCompileShader(id));
-
-  int result;
-  GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
-  if (result == GL_FALSE)
+  unsigned int id = SubmitShader(type, source);
+  if (!CheckCompileStatus(id, type))
   {
-    int length;
-    GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
-    char* message = (char*)alloca(length * sizeof(char));
-    GLCall(glGetShaderInfoLog(id, length, &length, message));
-    std::cerr << "Failed to compile shader! "
-              << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
-              << std::endl;
     std::cerr << "Source:\n"
               << "=======\n"
               << source << std::endl;
-    std::cerr << message << std::endl;
     GLCall(glDeleteShader(id));
     return -1;
   }
 
   return id;
 }
+
+/* Hands `source` to the compiler without asking how it went */
+unsigned int Shader::SubmitShader(unsigned int type, const std::string& source)
+{
+  GLCall(unsigned int id = glCreateShader(type));
+  const char* src = source.c_str();
+  GLCall(glShaderSource(id, 1, &src, 0));
+  GLCall(glCompileShader(id));
+  return id;
+}
+
+bool Shader::CheckCompileStatus(unsigned int id, unsigned int type)
+{
+  int result;
+  GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
+  if (result == GL_TRUE) return true;
+
+  int length;
+  GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
+  std::string message(length, '\0');
+  GLCall(glGetShaderInfoLog(id, length, &length, message.data()));
+  std::cerr << "Failed to compile shader! "
+            << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
+            << std::endl;
+  std::cerr << message << std::endl;
+  return false;
+}
+
+bool Shader::CheckLinkStatus(unsigned int program)
+{
+  int result;
+  GLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
+  if (result == GL_TRUE) return true;
+
+  int length;
+  GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+  std::string message(length, '\0');
+  GLCall(glGetProgramInfoLog(program, length, &length, message.data()));
+  std::cerr << "Failed to link shader!" << std::endl;
+  std::cerr << message << std::endl;
+  return false;
+}
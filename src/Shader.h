@@ -1,13 +1,17 @@
 #pragma once
 
 #include <GLM/glm.hpp>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 #include "Assert.h"
+#include "GLState.h"
+#include "ShaderCache.h"
+#include "Uniform.h"
+#include "UniformBuffer.h"
 
 struct ShaderProgramSource
 {
@@ -18,9 +22,19 @@ struct ShaderProgramSource
 class Shader
 {
 private:
+  /* a relink started by Reload() that the driver may still be working on */
+  struct PendingProgram
+  {
+    unsigned int Program = 0;
+    unsigned int Vertex = 0;
+    unsigned int Fragment = 0;
+    uint64_t Key = 0;
+  };
+
   std::string m_FilePath;
   unsigned int m_RendererID;
-  std::unordered_map<std::string, int> m_UniformLocationCache;
+  UniformTable m_Uniforms;
+  PendingProgram m_Pending;
 
 public:
   Shader(const std::string& filepath);
@@ -29,17 +43,46 @@ public:
   void Bind() const;
   void Unbind() const;
 
-  // Set uniforms
-  void SetUniform1i(const std::string& name, int v0);
-  void SetUniform1f(const std::string& name, float v0);
-  void SetUniform4f(
-      const std::string& name, float v0, float v1, float v2, float v3);
-  void SetUniformMat4f(const std::string& name, glm::mat4& matrix);
+  // Set uniforms, names written as literals are hashed at compile time
+  void SetUniform1i(Uniform name, int v0);
+  void SetUniform1iv(Uniform name, int count, const int* values);
+  void SetUniform1f(Uniform name, float v0);
+  void SetUniform4f(Uniform name, float v0, float v1, float v2, float v3);
+  void SetUniformMat4f(Uniform name, const glm::mat4& matrix);
+
+  inline int GetUniformLocation(Uniform name) { return m_Uniforms.Find(name); }
+
+  /* Points block `name` at `binding`. The blocks in UniformBlocks are done
+     automatically, this is for anything else. */
+  void BindUniformBlock(const std::string& name, UniformBinding binding);
+
+  /* Starts relinking from `source` without waiting on the driver. The
+     current program stays in use until UpdateReload() swaps the new one in,
+     and stays for good if the new one fails to build. */
+  void Reload(const ShaderProgramSource& source);
+  /* true once a pending reload is over, swapped in or thrown away */
+  bool UpdateReload();
+  inline bool IsReloading() const { return m_Pending.Program != 0; }
+
+  inline const std::string& GetFilePath() const { return m_FilePath; }
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+
+  /* doesn't touch GL, safe to call from any thread */
+  static ShaderProgramSource ParseShader(const std::string& filepath);
+  /* splits a whole .shader file that's already in memory */
+  static ShaderProgramSource ParseShaderSource(std::string_view file);
 
 private:
-  ShaderProgramSource ParseShader();
-  int GetUniformLocation(const std::string& name);
+  void BindKnownUniformBlocks();
+  void SwapProgram(unsigned int program);
+  void CopyUniforms(unsigned int from, unsigned int to);
+  void CopyUniformBlockBindings(unsigned int from, unsigned int to);
+  void DropPending();
   unsigned int CreateShader(
       const std::string& vertex_shader, const std::string& fragment_shader);
   unsigned int CompileShader(unsigned int type, const std::string& source);
+  static unsigned int SubmitShader(
+      unsigned int type, const std::string& source);
+  static bool CheckCompileStatus(unsigned int id, unsigned int type);
+  static bool CheckLinkStatus(unsigned int program);
 };
\ No newline at end of file
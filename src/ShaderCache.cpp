@@ -0,0 +1,114 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+static std::string s_Directory = ".shadercache";
+static bool s_Enabled = true;
+
+/* 64-bit FNV-1a; `hash` carries on from a previous call */
+static uint64_t Hash64(
+    std::string_view data, uint64_t hash = 14695981039346656037ull)
+{
+  for (char c : data)
+  {
+    hash ^= (uint8_t)c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+static const uint32_t CacheMagic = 0x42474f47; // "GOGB"
+
+void ShaderCache::SetDirectory(const std::string& directory)
+{
+  s_Directory = directory;
+}
+
+void ShaderCache::SetEnabled(bool enabled) { s_Enabled = enabled; }
+
+bool ShaderCache::IsSupported()
+{
+  static int formats = -1;
+  if (formats < 0)
+  {
+    formats = 0;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+    {
+      GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+    }
+    if (formats == 0)
+      std::cout << "Driver has no program binary formats, not caching shaders"
+                << std::endl;
+  }
+  return formats > 0;
+}
+
+uint64_t ShaderCache::Key(
+    const std::string& vertexSource, const std::string& fragmentSource)
+{
+  uint64_t hash = Hash64(vertexSource);
+  hash = Hash64("\x01", hash); // so moving text between stages changes it
+  hash = Hash64(fragmentSource, hash);
+  for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+    hash = Hash64((const char*)glGetString(name), hash);
+  return hash;
+}
+
+std::string ShaderCache::PathFor(uint64_t key)
+{
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+  return s_Directory + "/" + name;
+}
+
+unsigned int ShaderCache::Load(uint64_t key)
+{
+  if (!s_Enabled || !IsSupported()) return 0;
+
+  std::ifstream in(PathFor(key), std::ios::binary);
+  if (!in) return 0;
+
+  uint32_t header[3] = {}; // magic, format, length
+  in.read((char*)header, sizeof(header));
+  if (!in || header[0] != CacheMagic) return 0;
+  std::vector<char> binary(header[2]);
+  in.read(binary.data(), binary.size());
+  if (!in) return 0;
+
+  GLCall(unsigned int program = glCreateProgram());
+  GLCall(glProgramBinary(program, header[1], binary.data(), binary.size()));
+  int linked = GL_FALSE;
+  GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+  if (linked == GL_FALSE)
+  {
+    // stale, most likely a driver update that kept the version string
+    GLCall(glDeleteProgram(program));
+    return 0;
+  }
+  return program;
+}
+
+void ShaderCache::Store(uint64_t key, unsigned int program)
+{
+  if (!s_Enabled || !IsSupported()) return;
+
+  int length = 0;
+  GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+  if (length <= 0) return;
+
+  std::vector<char> binary(length);
+  GLenum format = 0;
+  GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+
+  std::error_code error;
+  std::filesystem::create_directories(s_Directory, error);
+  std::ofstream out(PathFor(key), std::ios::binary);
+  if (!out) return;
+  const uint32_t header[3] = { CacheMagic, format, (uint32_t)length };
+  out.write((const char*)header, sizeof(header));
+  out.write(binary.data(), length);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Assert.h"
+
+/*
+ * On-disk cache of linked program binaries. The key hashes both stages'
+ * source together with the GL vendor, renderer and version strings, since a
+ * binary is only good for the driver that produced it. On a hit the program
+ * comes from glProgramBinary and nothing gets compiled; on a miss Shader
+ * links as usual and hands the result to Store().
+ *
+ * Drivers are allowed to support zero binary formats (or to reject a binary
+ * they produced themselves after an update), in which case Load() just
+ * returns 0 and we compile like before.
+ */
+class ShaderCache
+{
+public:
+  static void SetDirectory(const std::string& directory);
+  static void SetEnabled(bool enabled);
+  static bool IsSupported();
+
+  static uint64_t Key(
+      const std::string& vertexSource, const std::string& fragmentSource);
+
+  /* A linked program, or 0 on a miss */
+  static unsigned int Load(uint64_t key);
+  static void Store(uint64_t key, unsigned int program);
+
+private:
+  static std::string PathFor(uint64_t key);
+};
\ No newline at end of file
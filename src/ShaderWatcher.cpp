@@ -0,0 +1,215 @@
+#include "ShaderWatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "Shader.h"
+
+namespace
+{
+struct WatchedShader
+{
+  Shader* Target;
+  std::string Path; // canonical, to compare against what inotify reports
+};
+
+struct ChangedSource
+{
+  std::string Path;
+  ShaderProgramSource Source;
+};
+
+std::mutex s_Mutex;
+std::vector<WatchedShader> s_Shaders;
+std::vector<ChangedSource> s_Changed;
+std::unordered_map<int, std::string> s_Directories; // watch descriptor -> dir
+std::thread s_Thread;
+std::atomic<bool> s_Stopping = false;
+int s_Fd = -1;
+
+std::string Canonical(const std::filesystem::path& path)
+{
+  std::error_code error;
+  std::filesystem::path canonical
+      = std::filesystem::weakly_canonical(path, error);
+  return error ? path.string() : canonical.string();
+}
+}
+
+void ShaderWatcher::Start()
+{
+  if (s_Running) return;
+#ifdef __linux__
+  s_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (s_Fd < 0)
+  {
+    std::cout << "Warning: inotify_init failed, shaders won't hot reload"
+              << std::endl;
+    return;
+  }
+  s_Running = true;
+  s_Stopping = false;
+
+  std::vector<std::string> directories;
+  {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (const WatchedShader& shader : s_Shaders)
+      directories.push_back(std::filesystem::path(shader.Path).parent_path());
+  }
+  for (const std::string& directory : directories)
+    AddWatch(directory);
+
+  s_Thread = std::thread(WatchLoop);
+#else
+  std::cout << "Warning: shader hot reload needs inotify, not watching"
+            << std::endl;
+#endif
+}
+
+void ShaderWatcher::Stop()
+{
+  if (!s_Running) return;
+  s_Stopping = true;
+  s_Thread.join();
+#ifdef __linux__
+  close(s_Fd);
+#endif
+  s_Fd = -1;
+  s_Running = false;
+
+  std::lock_guard<std::mutex> lock(s_Mutex);
+  s_Directories.clear();
+  s_Changed.clear();
+}
+
+unsigned int ShaderWatcher::Poll()
+{
+  std::vector<ChangedSource> changed;
+  std::vector<Shader*> shaders;
+  std::vector<std::string> paths;
+  {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    changed.swap(s_Changed);
+    for (const WatchedShader& shader : s_Shaders)
+    {
+      shaders.push_back(shader.Target);
+      paths.push_back(shader.Path);
+    }
+  }
+
+  // Shaders are created and destroyed on this thread too, so the pointers
+  // stay good without holding the lock across GL calls
+  for (const ChangedSource& change : changed)
+  {
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+      if (paths[i] != change.Path) continue;
+      std::cout << "Reloading " << shaders[i]->GetFilePath() << std::endl;
+      shaders[i]->Reload(change.Source);
+    }
+  }
+
+  unsigned int finished = 0;
+  for (Shader* shader : shaders)
+    finished += shader->UpdateReload();
+  return finished;
+}
+
+void ShaderWatcher::Watch(Shader* shader)
+{
+  std::string path = Canonical(shader->GetFilePath());
+  {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Shaders.push_back({ shader, path });
+  }
+  if (s_Running) AddWatch(std::filesystem::path(path).parent_path());
+}
+
+void ShaderWatcher::Unwatch(Shader* shader)
+{
+  std::lock_guard<std::mutex> lock(s_Mutex);
+  s_Shaders.erase(std::remove_if(s_Shaders.begin(), s_Shaders.end(),
+                      [&](const WatchedShader& watched) {
+                        return watched.Target == shader;
+                      }),
+      s_Shaders.end());
+}
+
+void ShaderWatcher::AddWatch(const std::string& directory)
+{
+#ifdef __linux__
+  // editors either write in place or write a temp file and rename it over
+  int wd = inotify_add_watch(
+      s_Fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (wd < 0)
+  {
+    std::cout << "Warning: can't watch " << directory << std::endl;
+    return;
+  }
+  // the same directory twice gives back the same descriptor
+  std::lock_guard<std::mutex> lock(s_Mutex);
+  s_Directories[wd] = directory;
+#endif
+}
+
+void ShaderWatcher::WatchLoop()
+{
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+  while (!s_Stopping)
+  {
+    pollfd fd = { s_Fd, POLLIN, 0 };
+    if (poll(&fd, 1, 100) <= 0) continue;
+
+    std::vector<std::string> paths;
+    ssize_t length;
+    while ((length = read(s_Fd, buffer, sizeof(buffer))) > 0)
+    {
+      for (char* at = buffer; at < buffer + length;)
+      {
+        inotify_event* event = (inotify_event*)at;
+        at += sizeof(inotify_event) + event->len;
+        if (!event->len) continue;
+
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        auto directory = s_Directories.find(event->wd);
+        if (directory == s_Directories.end()) continue;
+        std::string path
+            = (std::filesystem::path(directory->second) / event->name).string();
+        bool watched = std::any_of(s_Shaders.begin(), s_Shaders.end(),
+            [&](const WatchedShader& shader) { return shader.Path == path; });
+        if (watched && std::count(paths.begin(), paths.end(), path) == 0)
+          paths.push_back(path);
+      }
+    }
+
+    for (const std::string& path : paths)
+    {
+      ShaderProgramSource source = Shader::ParseShader(path);
+      // caught it halfway through a save, the next event has the rest
+      if (source.VertexSource.empty() || source.FragmentSource.empty())
+        continue;
+      std::lock_guard<std::mutex> lock(s_Mutex);
+      // only the newest source per file matters
+      s_Changed.erase(std::remove_if(s_Changed.begin(), s_Changed.end(),
+                          [&](const ChangedSource& change) {
+                            return change.Path == path;
+                          }),
+          s_Changed.end());
+      s_Changed.push_back({ path, std::move(source) });
+    }
+  }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+class Shader;
+
+/*
+ * Hot reload for shader files. A thread sits on inotify watches for the
+ * directories every live Shader was loaded from, and when one of those files
+ * is written it re-parses it right there, off the GL thread. Poll() then
+ * hands the new source to the Shader, which relinks in the background (with
+ * KHR_parallel_shader_compile) and swaps once the driver is done.
+ *
+ * Shaders register themselves, nothing is watched until Start().
+ */
+class ShaderWatcher
+{
+public:
+  static void Start();
+  static void Stop();
+  inline static bool IsRunning() { return s_Running; }
+
+  /* GL thread, once a frame. Returns how many reloads finished, whether they
+     were swapped in or thrown out for not compiling. */
+  static unsigned int Poll();
+
+  static void Watch(Shader* shader);
+  static void Unwatch(Shader* shader);
+
+private:
+  inline static bool s_Running = false;
+
+  static void AddWatch(const std::string& directory);
+  static void WatchLoop();
+};
\ No newline at end of file
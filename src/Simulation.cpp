@@ -0,0 +1,97 @@
+#include "Simulation.h"
+
+#include <algorithm>
+#include <utility>
+
+static double ToMs(Simulation::Clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+Simulation::Simulation(double ticksPerSecond, TickFunction tick)
+    : m_Tick(std::move(tick))
+    , m_Timestep(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / ticksPerSecond)))
+    , m_Running(false)
+    , m_Unthrottled(false)
+{
+}
+
+Simulation::~Simulation() { Stop(); }
+
+void Simulation::Start()
+{
+  if (m_Running) return;
+  m_Running = true;
+  m_Thread = std::thread(&Simulation::Run, this);
+}
+
+void Simulation::Stop()
+{
+  if (!m_Running) return;
+  m_Running = false;
+  m_Thread.join();
+}
+
+double Simulation::GetAlpha(Clock::time_point due, Clock::time_point now) const
+{
+  if (m_Unthrottled) return 1.0;
+  return std::clamp(
+      std::chrono::duration<double>(now - due).count() / GetTimestep(), 0.0,
+      1.0);
+}
+
+const SimulationStats& Simulation::GetStats()
+{
+  m_Stats.Acquire();
+  return m_Stats.GetFront();
+}
+
+void Simulation::Run()
+{
+  SimulationStats stats;
+  double jitterTotal = 0.0;
+  uint64_t index = 0;
+  Clock::time_point previous = Clock::now();
+  Clock::time_point due = previous;
+  Clock::duration accumulator = m_Timestep; // first tick straight away
+
+  while (m_Running)
+  {
+    const Clock::time_point now = Clock::now();
+    if (m_Unthrottled)
+    {
+      accumulator = m_Timestep;
+      due = now;
+    }
+    else
+      accumulator += now - previous;
+    previous = now;
+
+    if (accumulator > MaxCatchUp * m_Timestep)
+    {
+      stats.TicksDropped += accumulator / m_Timestep - 1;
+      accumulator = m_Timestep;
+      due = now;
+    }
+
+    while (accumulator >= m_Timestep && m_Running)
+    {
+      const Clock::time_point start = Clock::now();
+      m_Tick({ index, GetTimestep(), due });
+      stats.TickMs = ToMs(Clock::now() - start);
+      stats.JitterMs = ToMs(start - due);
+      stats.MaxJitterMs = std::max(stats.MaxJitterMs, stats.JitterMs);
+      jitterTotal += stats.JitterMs;
+      stats.Ticks = ++index;
+      stats.MeanJitterMs = jitterTotal / index;
+
+      accumulator -= m_Timestep;
+      due += m_Timestep;
+    }
+
+    m_Stats.GetBack() = stats;
+    m_Stats.Publish();
+    if (!m_Unthrottled) std::this_thread::sleep_for(m_Timestep - accumulator);
+  }
+}
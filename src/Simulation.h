@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "SnapshotBuffer.h"
+
+/* What a tick is told about itself */
+struct SimulationTick
+{
+  uint64_t Index;
+  double Timestep; // seconds, the same every tick
+  std::chrono::steady_clock::time_point Due; // when it should have run
+};
+
+struct SimulationStats
+{
+  uint64_t Ticks = 0;
+  uint64_t TicksDropped = 0; // skipped after falling too far behind
+  double TickMs = 0.0;       // the last one's run time
+  double JitterMs = 0.0;     // how late the last tick started
+  double MeanJitterMs = 0.0;
+  double MaxJitterMs = 0.0;
+};
+
+/*
+ * Runs a tick function on its own thread at a fixed rate, however fast or
+ * slow the renderer is. Wall time goes into an accumulator and comes out one
+ * whole timestep per tick, the thread sleeps for whatever is left over. A
+ * tick that runs long is caught up on with back-to-back ticks; after more
+ * than MaxCatchUp of those the backlog is dropped instead, so a breakpoint
+ * doesn't turn into a few seconds of fast forward.
+ *
+ * The tick publishes its own state (typically through a SnapshotBuffer) and
+ * the renderer interpolates between the two newest with GetAlpha().
+ * Unthrottled, it ticks as fast as it can with no sleeping, for benchmarks
+ * and replays; Due is then just the time the tick started.
+ */
+class Simulation
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using TickFunction = std::function<void(const SimulationTick&)>;
+
+  static const unsigned int MaxCatchUp = 8;
+
+private:
+  TickFunction m_Tick;
+  Clock::duration m_Timestep;
+  std::thread m_Thread;
+  std::atomic<bool> m_Running;
+  std::atomic<bool> m_Unthrottled;
+  SnapshotBuffer<SimulationStats> m_Stats;
+
+public:
+  Simulation(double ticksPerSecond, TickFunction tick);
+  ~Simulation();
+
+  void Start();
+  void Stop();
+
+  inline void SetUnthrottled(bool unthrottled) { m_Unthrottled = unthrottled; }
+  inline bool IsUnthrottled() const { return m_Unthrottled; }
+  inline double GetTimestep() const
+  {
+    return std::chrono::duration<double>(m_Timestep).count();
+  }
+
+  /* How far `now` is past a tick that was Due at `due`, in timesteps,
+     clamped to [0, 1]: the blend from that tick's previous state to its
+     new one. Always 1 unthrottled. */
+  double GetAlpha(Clock::time_point due, Clock::time_point now) const;
+
+  /* Latest figures. One reader, like any SnapshotBuffer. */
+  const SimulationStats& GetStats();
+
+private:
+  void Run();
+};
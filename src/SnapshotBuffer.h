@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+/*
+ * Hands the latest T from one thread to another without either of them
+ * waiting: three slots, the producer writes one, the consumer reads another
+ * and the third is the newest finished one, swapped with a single atomic
+ * exchange on either side. The consumer always gets the most recent T that
+ * was published and never one that's still being written; anything the
+ * producer publishes twice before the consumer looks is simply replaced.
+ *
+ *   producer: buffer.GetBack() = ...; buffer.Publish();
+ *   consumer: buffer.Acquire(); use(buffer.GetFront());
+ *
+ * One producer thread and one consumer thread.
+ */
+template <typename T> class SnapshotBuffer
+{
+private:
+  static const unsigned int FreshBit = 4; // the middle slot is unread
+
+  std::array<T, 3> m_Slots;
+  unsigned int m_Back;                // producer's
+  std::atomic<unsigned int> m_Middle; // slot index | FreshBit
+  unsigned int m_Front;               // consumer's
+
+public:
+  SnapshotBuffer()
+      : m_Back(0)
+      , m_Middle(1)
+      , m_Front(2)
+  {
+  }
+
+  /* before either thread starts, e.g. to reserve every slot's vectors */
+  template <typename F> void ForEach(F&& function)
+  {
+    for (T& slot : m_Slots)
+      function(slot);
+  }
+
+  inline T& GetBack() { return m_Slots[m_Back]; }
+  inline void Publish()
+  {
+    m_Back = m_Middle.exchange(m_Back | FreshBit, std::memory_order_acq_rel)
+             & ~FreshBit;
+  }
+
+  /* true if there was something newer than GetFront() */
+  inline bool Acquire()
+  {
+    if (!(m_Middle.load(std::memory_order_relaxed) & FreshBit)) return false;
+    m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel)
+              & ~FreshBit;
+    return true;
+  }
+  inline const T& GetFront() const { return m_Slots[m_Front]; }
+};
@@ -0,0 +1,173 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "Assert.h"
+#include "Profiler.h"
+
+SpatialGrid::SpatialGrid(float cellSize /*= 128.0f */)
+    : m_CellSize(cellSize)
+    , m_Count(0)
+    , m_Stamp(0)
+{
+}
+
+void SpatialGrid::Insert(unsigned int id, const Bounds& bounds)
+{
+  if (id >= m_Items.size()) m_Items.resize(id + 1, { {}, {}, 0, false });
+  Item& item = m_Items[id];
+  ASSERT(!item.Present);
+  item.Box = bounds;
+  item.Cells = CellsFor(bounds);
+  item.Present = true;
+  Link(id, item.Cells);
+  m_Count++;
+}
+
+void SpatialGrid::Update(unsigned int id, const Bounds& bounds)
+{
+  Item& item = m_Items[id];
+  item.Box = bounds;
+  CellRange cells = CellsFor(bounds);
+  if (cells == item.Cells) return;
+
+  Unlink(id, item.Cells);
+  Link(id, cells);
+  item.Cells = cells;
+}
+
+void SpatialGrid::Remove(unsigned int id)
+{
+  Item& item = m_Items[id];
+  ASSERT(item.Present);
+  Unlink(id, item.Cells);
+  item.Present = false;
+  m_Count--;
+}
+
+void SpatialGrid::Query(
+    const Bounds& bounds, std::vector<unsigned int>& visible)
+{
+  PROFILE_SCOPE("Cull");
+  auto start = std::chrono::steady_clock::now();
+  m_Stats = CullStats();
+  m_Stats.Items = m_Count;
+
+  // anything in more than one cell would otherwise come back once per cell
+  if (++m_Stamp == 0)
+  {
+    for (Item& item : m_Items)
+      item.Stamp = 0;
+    m_Stamp = 1;
+  }
+
+  CellRange range = CellsFor(bounds);
+  for (int y = range.MinY; y <= range.MaxY; y++)
+  {
+    for (int x = range.MinX; x <= range.MaxX; x++)
+    {
+      auto cell = m_Cells.find(CellKey(x, y));
+      if (cell == m_Cells.end()) continue;
+      for (const CellChunk* chunk = cell->second; chunk; chunk = chunk->Next)
+      {
+        for (unsigned int i = 0; i < chunk->Count; i++)
+        {
+          unsigned int id = chunk->Ids[i];
+          Item& item = m_Items[id];
+          if (item.Stamp == m_Stamp) continue;
+          item.Stamp = m_Stamp;
+          m_Stats.Candidates++;
+          if (item.Box.Overlaps(bounds))
+          {
+            visible.push_back(id);
+            m_Stats.Visible++;
+          }
+        }
+      }
+    }
+  }
+
+  m_Stats.QueryMs = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start)
+                        .count();
+}
+
+Bounds SpatialGrid::ViewBounds(const glm::mat4& viewProjection)
+{
+  // in 2D the NDC position is a 2x2 matrix and an offset away from the world
+  // one; invert that and push the NDC corners back through it
+  const glm::mat4& m = viewProjection;
+  float a = m[0][0], b = m[1][0], c = m[0][1], d = m[1][1];
+  float determinant = a * d - b * c;
+  ASSERT(determinant != 0.0f);
+
+  Bounds bounds = { glm::vec2(INFINITY), glm::vec2(-INFINITY) };
+  for (float nx : { -1.0f, 1.0f })
+  {
+    for (float ny : { -1.0f, 1.0f })
+    {
+      float px = nx - m[3][0], py = ny - m[3][1];
+      glm::vec2 world((d * px - b * py) / determinant,
+          (a * py - c * px) / determinant);
+      bounds.Min = glm::vec2(
+          std::min(bounds.Min.x, world.x), std::min(bounds.Min.y, world.y));
+      bounds.Max = glm::vec2(
+          std::max(bounds.Max.x, world.x), std::max(bounds.Max.y, world.y));
+    }
+  }
+  return bounds;
+}
+
+SpatialGrid::CellRange SpatialGrid::CellsFor(const Bounds& bounds) const
+{
+  return { (int)std::floor(bounds.Min.x / m_CellSize),
+    (int)std::floor(bounds.Min.y / m_CellSize),
+    (int)std::floor(bounds.Max.x / m_CellSize),
+    (int)std::floor(bounds.Max.y / m_CellSize) };
+}
+
+void SpatialGrid::Link(unsigned int id, const CellRange& cells)
+{
+  for (int y = cells.MinY; y <= cells.MaxY; y++)
+  {
+    for (int x = cells.MinX; x <= cells.MaxX; x++)
+    {
+      CellChunk*& head = m_Cells[CellKey(x, y)];
+      if (!head || head->Count == CellChunk::Capacity)
+        head = m_Chunks.New(CellChunk { {}, 0, head });
+      head->Ids[head->Count++] = id;
+    }
+  }
+}
+
+void SpatialGrid::Unlink(unsigned int id, const CellRange& cells)
+{
+  for (int y = cells.MinY; y <= cells.MaxY; y++)
+  {
+    for (int x = cells.MinX; x <= cells.MaxX; x++)
+    {
+      // cells are short, a linear search and a swap with the last id of the
+      // first chunk is fine; the map entry stays, it'll likely be used again
+      CellChunk*& head = m_Cells.find(CellKey(x, y))->second;
+      unsigned int* found = nullptr;
+      for (CellChunk* chunk = head; chunk && !found; chunk = chunk->Next)
+        for (unsigned int i = 0; i < chunk->Count && !found; i++)
+          if (chunk->Ids[i] == id) found = &chunk->Ids[i];
+      ASSERT(found);
+      *found = head->Ids[--head->Count];
+      if (head->Count == 0)
+      {
+        CellChunk* empty = head;
+        head = head->Next;
+        m_Chunks.Delete(empty);
+      }
+    }
+  }
+}
+
+uint64_t SpatialGrid::CellKey(int x, int y)
+{
+  return (uint64_t)(uint32_t)x << 32 | (uint32_t)y;
+}
\ No newline at end of file
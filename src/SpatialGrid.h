@@ -0,0 +1,103 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Pool.h"
+
+/* Axis aligned box in world units */
+struct Bounds
+{
+  glm::vec2 Min;
+  glm::vec2 Max;
+
+  inline bool Overlaps(const Bounds& other) const
+  {
+    return Min.x <= other.Max.x && Max.x >= other.Min.x
+           && Min.y <= other.Max.y && Max.y >= other.Min.y;
+  }
+};
+
+/* What the last Query() did */
+struct CullStats
+{
+  unsigned int Items = 0;      // everything in the grid
+  unsigned int Candidates = 0; // in the cells the query touched
+  unsigned int Visible = 0;    // actually overlapping the query box
+  double QueryMs = 0.0;
+};
+
+/*
+ * Uniform grid over 2D bounds for culling. Cells live in a hash map, so the
+ * world can be any size and empty space costs nothing. Ids are the caller's
+ * own (an index into its sprite array, say). A cell's ids are kept in
+ * cache-line sized chunks from a pool, so objects moving from cell to cell
+ * recycle chunks rather than growing vectors.
+ *
+ * Moving objects call Update() every time they move; while they stay inside
+ * the same cells that's just a store, they only get relinked when they cross
+ * a cell edge. Pick a cell size a few times the typical object so that
+ * doesn't happen often and most objects sit in a single cell.
+ */
+class SpatialGrid
+{
+private:
+  struct CellRange
+  {
+    int MinX, MinY, MaxX, MaxY;
+    bool operator==(const CellRange& other) const
+    {
+      return MinX == other.MinX && MinY == other.MinY && MaxX == other.MaxX
+             && MaxY == other.MaxY;
+    }
+  };
+
+  /* only the first chunk of a cell is ever partly full */
+  struct CellChunk
+  {
+    static const unsigned int Capacity = 13; // 64 bytes all told
+    unsigned int Ids[Capacity];
+    unsigned int Count;
+    CellChunk* Next;
+  };
+
+  struct Item
+  {
+    Bounds Box;
+    CellRange Cells;
+    uint32_t Stamp; // last query that looked at it, to skip duplicates
+    bool Present;
+  };
+
+  float m_CellSize;
+  std::unordered_map<uint64_t, CellChunk*> m_Cells; // null once emptied
+  Pool<CellChunk> m_Chunks;
+  std::vector<Item> m_Items;
+  unsigned int m_Count;
+  uint32_t m_Stamp;
+  CullStats m_Stats;
+
+public:
+  SpatialGrid(float cellSize = 128.0f);
+
+  void Insert(unsigned int id, const Bounds& bounds);
+  void Update(unsigned int id, const Bounds& bounds);
+  void Remove(unsigned int id);
+
+  /* Appends the id of everything overlapping `bounds` to `visible` */
+  void Query(const Bounds& bounds, std::vector<unsigned int>& visible);
+
+  inline const CullStats& GetStats() const { return m_Stats; }
+  inline unsigned int GetCount() const { return m_Count; }
+
+  /* What an orthographic viewProjection (with any 2D view) can see */
+  static Bounds ViewBounds(const glm::mat4& viewProjection);
+
+private:
+  CellRange CellsFor(const Bounds& bounds) const;
+  void Link(unsigned int id, const CellRange& cells);
+  void Unlink(unsigned int id, const CellRange& cells);
+  static uint64_t CellKey(int x, int y);
+};
\ No newline at end of file
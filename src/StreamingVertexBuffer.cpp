@@ -0,0 +1,142 @@
+#include "StreamingVertexBuffer.h"
+
+#include <chrono>
+
+#include "RenderStats.h"
+
+StreamingVertexBuffer::StreamingVertexBuffer(unsigned int regionSize)
+    : m_RendererID(0)
+    , m_RegionSize(regionSize)
+    , m_Region(0)
+    , m_Cursor(0)
+    , m_Mapped(~0u)
+    , m_Persistent(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage)
+    , m_Memory(nullptr)
+    , m_Fences {}
+{
+  const unsigned int size = m_RegionSize * RegionCount;
+  GLCall(glGenBuffers(1, &m_RendererID));
+  Bind();
+  if (m_Persistent)
+  {
+    const GLbitfield flags
+        = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+    GLCall(m_Memory = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+  }
+  else
+  {
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+  }
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+  for (GLsync fence : m_Fences)
+  {
+    if (fence)
+    {
+      GLCall(glDeleteSync(fence));
+    }
+  }
+  if (m_Memory)
+  {
+    Bind();
+    GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+  }
+  GLState::ForgetBuffer(m_RendererID);
+  GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void* StreamingVertexBuffer::Map(unsigned int size, unsigned int alignment)
+{
+  ASSERT(m_Mapped == ~0u);
+  ASSERT(size <= m_RegionSize);
+
+  unsigned int start = (m_Cursor + alignment - 1) / alignment * alignment;
+  if (start + size > (m_Region + 1) * m_RegionSize)
+  {
+    NextRegion();
+    start = m_Cursor;
+  }
+  m_Mapped = start;
+
+  if (m_Persistent) return m_Memory + start;
+
+  // the fences are what keep this safe, so the driver needn't bother
+  Bind();
+  GLCall(void* memory = glMapBufferRange(GL_ARRAY_BUFFER, start, size,
+             GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+                 | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+  return memory;
+}
+
+unsigned int StreamingVertexBuffer::Unmap(unsigned int size)
+{
+  ASSERT(m_Mapped != ~0u);
+  unsigned int offset = m_Mapped;
+  m_Mapped = ~0u;
+
+  if (!m_Persistent)
+  {
+    Bind();
+    GLCall(glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, size));
+    GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+  }
+
+  m_Cursor = offset + size;
+  m_Stats.BytesWritten += size;
+  return offset;
+}
+
+void StreamingVertexBuffer::Bind() const
+{
+  GLState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void StreamingVertexBuffer::Unbind() const
+{
+  GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamingVertexBuffer::ResetStats() { m_Stats = StreamingStats(); }
+
+void StreamingVertexBuffer::NextRegion()
+{
+  // everything drawn out of this region so far is behind this fence
+  GLCall(m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  m_Region = (m_Region + 1) % RegionCount;
+  m_Cursor = m_Region * m_RegionSize;
+  m_Stats.Wraps++;
+  WaitForRegion(m_Region);
+}
+
+void StreamingVertexBuffer::WaitForRegion(unsigned int region)
+{
+  GLsync& fence = m_Fences[region];
+  if (!fence) return;
+
+  GLCall(GLenum status = glClientWaitSync(fence, 0, 0));
+  if (status == GL_TIMEOUT_EXPIRED)
+  {
+    // the GPU is a full ring behind us
+    auto start = std::chrono::steady_clock::now();
+    // flush once so the fence is guaranteed to get somewhere
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    do
+    {
+      GLCall(status = glClientWaitSync(fence, flags, 1000000));
+      flags = 0;
+    } while (status == GL_TIMEOUT_EXPIRED);
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start)
+                    .count();
+    m_Stats.FenceWaitMs += ms;
+    m_Stats.Stalls++;
+    RenderStats::Get().FenceWaitMs += ms;
+  }
+  ASSERT(status != GL_WAIT_FAILED);
+
+  GLCall(glDeleteSync(fence));
+  fence = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+
+#include "Assert.h"
+#include "GLState.h"
+
+/* Counters since the last ResetStats() */
+struct StreamingStats
+{
+  double FenceWaitMs = 0.0;   // blocked in glClientWaitSync
+  unsigned int Stalls = 0;    // region still in use when we came back to it
+  unsigned int Wraps = 0;     // times we moved on to the next region
+  unsigned int BytesWritten = 0;
+};
+
+/*
+ * Vertex buffer for data that changes every frame. The storage is split into
+ * RegionCount regions used as a ring: writes go to the current region until
+ * it fills, at which point a fence goes in behind the draws that read it and
+ * we move on to the next one, waiting on that region's fence first if the GPU
+ * hasn't got through it yet. Nothing the GPU might still read ever gets
+ * overwritten, and the driver never has to orphan or synchronise anything.
+ *
+ * With GL 4.4 / ARB_buffer_storage the whole buffer is mapped once,
+ * persistent and coherent, and Map() just hands out pointers into it.
+ * Otherwise every Map() is a glMapBufferRange with UNSYNCHRONIZED, which is
+ * safe for the same reason.
+ *
+ *   void* vertices = stream.Map(bytes, sizeof(Vertex));
+ *   ... write up to `bytes` ...
+ *   unsigned int offset = stream.Unmap(written);
+ *   glDrawElementsBaseVertex(..., offset / sizeof(Vertex));
+ */
+class StreamingVertexBuffer
+{
+public:
+  static const unsigned int RegionCount = 3;
+
+private:
+  unsigned int m_RendererID;
+  unsigned int m_RegionSize;
+  unsigned int m_Region;   // region being written
+  unsigned int m_Cursor;   // byte offset into the whole buffer
+  unsigned int m_Mapped;   // offset of the outstanding Map(), or ~0u
+  bool m_Persistent;
+  char* m_Memory; // persistent mapping of the whole buffer
+  std::array<GLsync, RegionCount> m_Fences;
+  StreamingStats m_Stats;
+
+public:
+  /* `regionSize` bytes per region, has to fit the largest single Map() */
+  StreamingVertexBuffer(unsigned int regionSize);
+  ~StreamingVertexBuffer();
+
+  /* Room for `size` bytes starting on a multiple of `alignment` (the vertex
+     size, for base vertex draws). Write, then Unmap() before drawing. */
+  void* Map(unsigned int size, unsigned int alignment = 1);
+  /* Keeps the first `size` bytes of the last Map(), returns their offset */
+  unsigned int Unmap(unsigned int size);
+
+  void Bind() const;
+  void Unbind() const;
+
+  inline bool IsPersistent() const { return m_Persistent; }
+  inline const StreamingStats& GetStats() const { return m_Stats; }
+  void ResetStats();
+
+private:
+  void NextRegion();
+  void WaitForRegion(unsigned int region);
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Texture.h"
 
+#include "ResourcePack.h"
+
 Texture::Texture(const std::string& filepath)
     : m_RendererID(0)
     , m_FilePath(filepath)
@@ -7,13 +9,62 @@ Texture::Texture(const std::string& filepath)
     , m_Width(0)
     , m_Height(0)
     , m_BPP(0)
+    , m_Bytes(0)
+    , m_Ready(true)
 {
+  // out of the mounted pack if it's in there, without a copy either way
+  std::span<const unsigned char> packed = ResourcePack::Lookup(filepath);
+  TextureFile file;
+  if (packed.empty() ? file.Open(filepath) : file.Open(packed))
+  {
+    Create(file);
+    return;
+  }
+
   stbi_set_flip_vertically_on_load(1); // ogl has y=0 at the bottom
-  m_LocalBuffer = stbi_load(filepath.c_str(), &m_Width, &m_Height, &m_BPP,
-      4); // 4 = RGBA for channels
+  if (packed.empty())
+    m_LocalBuffer = stbi_load(filepath.c_str(), &m_Width, &m_Height, &m_BPP,
+        4); // 4 = RGBA for channels
+  else
+    m_LocalBuffer = stbi_load_from_memory(packed.data(), (int)packed.size(),
+        &m_Width, &m_Height, &m_BPP, 4);
+
+  Create(m_LocalBuffer);
+
+  if (m_LocalBuffer) stbi_image_free(m_LocalBuffer);
+  m_LocalBuffer = nullptr;
+}
+
+Texture::Texture(int width, int height, const unsigned char* data)
+    : m_RendererID(0)
+    , m_LocalBuffer(nullptr)
+    , m_Width(width)
+    , m_Height(height)
+    , m_BPP(4)
+    , m_Bytes(0)
+    , m_Ready(true)
+{
+  Create(data);
+}
 
+Texture::~Texture()
+{
+  GLState::ForgetTexture(m_RendererID);
+  GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+std::shared_ptr<Texture> Texture::CreatePlaceholder()
+{
+  const unsigned char grey[] = { 128, 128, 128, 255 };
+  auto texture = std::make_shared<Texture>(1, 1, grey);
+  texture->m_Ready = false;
+  return texture;
+}
+
+void Texture::Create(const void* data)
+{
   GLCall(glGenTextures(1, &m_RendererID));
-  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+  GLState::BindTextureForEdit(m_RendererID);
 
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
@@ -21,19 +72,114 @@ Texture::Texture(const std::string& filepath)
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
   // level=0, border=0
-  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
-  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+  m_Bytes = (size_t)m_Width * m_Height * 4;
+  Unbind();
+}
 
-  if (m_LocalBuffer) stbi_image_free(m_LocalBuffer);
+static unsigned int InternalFormat(TextureFormat format)
+{
+  switch (format)
+  {
+    case TextureFormat::RGBA8: return GL_RGBA8;
+    case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureFormat::ETC2: return GL_COMPRESSED_RGB8_ETC2;
+  }
+  return GL_RGBA8;
 }
 
-Texture::~Texture() { GLCall(glDeleteTextures(1, &m_RendererID)); }
+bool Texture::IsFormatSupported(TextureFormat format)
+{
+  switch (format)
+  {
+    case TextureFormat::RGBA8: return true;
+    case TextureFormat::BC1:
+    case TextureFormat::BC3: return GLEW_EXT_texture_compression_s3tc;
+    case TextureFormat::ETC2:
+      return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+  }
+  return false;
+}
+
+/* Straight from the mapping, no decode and no copy on our side. Levels are
+   whatever the file has, so the filter only uses mips when there are some. */
+void Texture::Create(const TextureFile& file)
+{
+  const TextureFormat format = file.GetFormat();
+  m_Width = file.GetWidth();
+  m_Height = file.GetHeight();
+  m_BPP = format == TextureFormat::RGBA8 ? 4 : 0;
+
+  GLCall(glGenTextures(1, &m_RendererID));
+  GLState::BindTextureForEdit(m_RendererID);
+  if (!IsFormatSupported(format))
+  {
+    std::cout << "Texture " << m_FilePath << " is "
+              << TextureFile::GetFormatName(format)
+              << ", which this driver can't sample" << std::endl;
+    Unbind();
+    return;
+  }
+
+  const unsigned int levels = file.GetLevelCount();
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+      levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+
+  for (unsigned int i = 0; i < levels; i++)
+  {
+    const TextureLevel& level = file.GetLevel(i);
+    if (format == TextureFormat::RGBA8)
+    {
+      GLCall(glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, level.Width,
+          level.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.Data));
+    }
+    else
+    {
+      GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, i, InternalFormat(format),
+          level.Width, level.Height, 0, level.Size, level.Data));
+    }
+    m_Bytes += level.Size;
+  }
+  Unbind();
+}
+
+void Texture::SetImage(int width, int height, const void* data)
+{
+  m_Width = width;
+  m_Height = height;
+  m_BPP = 4;
+  m_Bytes = (size_t)width * height * 4;
+  GLState::BindTextureForEdit(m_RendererID);
+  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+  m_Ready = true;
+}
+
+void Texture::SetSubImage(int x, int y, int width, int height, const void* data)
+{
+  GLState::BindTextureForEdit(m_RendererID);
+  GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+}
+
+std::vector<unsigned char> Texture::ReadPixels() const
+{
+  std::vector<unsigned char> pixels((size_t)m_Width * m_Height * 4);
+  GLState::BindTextureForEdit(m_RendererID);
+  GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  GLCall(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+  return pixels;
+}
 
 void Texture::Bind(unsigned int slot /*= 0 */) const
 {
-  // GL_TEXTUREn is just GL_TEXTURE0 + n
-  GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+  GLState::BindTexture(slot, m_RendererID);
 }
 
-void Texture::Unbind() const { GLCall(glBindTexture(GL_TEXTURE_2D, 0)) }
\ No newline at end of file
+void Texture::Unbind(unsigned int slot /*= 0 */) const
+{
+  GLState::BindTexture(slot, 0);
+}
\ No newline at end of file
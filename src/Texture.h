@@ -1,6 +1,11 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "Assert.h"
+#include "GLState.h"
+#include "TextureFile.h"
 #include "stb_image/stb_image.h"
 
 class Texture
@@ -10,15 +15,42 @@ private:
   std::string m_FilePath;
   unsigned char* m_LocalBuffer;
   int m_Width, m_Height, m_BPP;
+  size_t m_Bytes; // every level as the GPU stores it
+  bool m_Ready;
 
 public:
+  /* A file texbake wrote is mapped and its levels uploaded as they are,
+     anything else is decoded with stb_image into RGBA8 without mips. */
   Texture(const std::string& filepath);
+  /* RGBA8 texture straight from memory, e.g. a generated white pixel */
+  Texture(int width, int height, const unsigned char* data);
   ~Texture();
 
+  /* 1x1 grey stand-in that isn't IsReady() until SetImage, the
+     TextureLoader hands these out while the real image decodes */
+  static std::shared_ptr<Texture> CreatePlaceholder();
+
+  /* Replaces the whole image with RGBA8 `data`. With a pixel unpack buffer
+     bound, `data` is an offset into it instead. */
+  void SetImage(int width, int height, const void* data);
+  /* RGBA8 `data` into the rectangle at x, y (from the bottom left) */
+  void SetSubImage(int x, int y, int width, int height, const void* data);
+  /* Reads the image back, RGBA8, bottom row first. Stalls, tools only. */
+  std::vector<unsigned char> ReadPixels() const;
+
   void Bind(unsigned int slot = 0) const;
-  void Unbind() const;
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+  void Unbind(unsigned int slot = 0) const;
 
   inline int GetWidth() const { return m_Width; }
   inline int GetHeight() const { return m_Height; }
+  inline bool IsReady() const { return m_Ready; }
+  inline size_t GetByteSize() const { return m_Bytes; }
 
+  /* whether the driver can sample `format`; RGBA8 always */
+  static bool IsFormatSupported(TextureFormat format);
+
+private:
+  void Create(const void* data);
+  void Create(const TextureFile& file);
 };
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : m_Width(width)
+    , m_Height(height)
+    , m_Skyline { { 0, 0, width } }
+{
+}
+
+/* Can a width x height rect start at node `index`? `y` is where it'd sit. */
+bool SkylinePacker::Fits(size_t index, int width, int height, int& y) const
+{
+  if (m_Skyline[index].X + width > m_Width) return false;
+
+  y = m_Skyline[index].Y;
+  int widthLeft = width;
+  for (size_t i = index; widthLeft > 0; i++)
+  {
+    y = std::max(y, m_Skyline[i].Y);
+    if (y + height > m_Height) return false;
+    widthLeft -= m_Skyline[i].Width;
+  }
+  return true;
+}
+
+bool SkylinePacker::Pack(int width, int height, int& x, int& y)
+{
+  size_t best = m_Skyline.size();
+  int bestTop = INT_MAX, bestWidth = INT_MAX;
+  for (size_t i = 0; i < m_Skyline.size(); i++)
+  {
+    int top;
+    if (!Fits(i, width, height, top)) continue;
+    top += height;
+    if (top < bestTop || (top == bestTop && m_Skyline[i].Width < bestWidth))
+    {
+      best = i;
+      bestTop = top;
+      bestWidth = m_Skyline[i].Width;
+    }
+  }
+  if (best == m_Skyline.size()) return false;
+
+  x = m_Skyline[best].X;
+  y = bestTop - height;
+  m_Skyline.insert(m_Skyline.begin() + best, { x, bestTop, width });
+
+  // whatever the new segment now covers gets cut off or removed
+  for (size_t i = best + 1; i < m_Skyline.size(); i++)
+  {
+    const Node& previous = m_Skyline[i - 1];
+    Node& node = m_Skyline[i];
+    int overlap = previous.X + previous.Width - node.X;
+    if (overlap <= 0) break;
+    node.X += overlap;
+    node.Width -= overlap;
+    if (node.Width > 0) break;
+    m_Skyline.erase(m_Skyline.begin() + i--);
+  }
+
+  // and neighbours at the same height become one segment
+  for (size_t i = 0; i + 1 < m_Skyline.size(); i++)
+  {
+    if (m_Skyline[i].Y != m_Skyline[i + 1].Y) continue;
+    m_Skyline[i].Width += m_Skyline[i + 1].Width;
+    m_Skyline.erase(m_Skyline.begin() + i + 1);
+    i--;
+  }
+  return true;
+}
+
+TextureAtlas::TextureAtlas(int pageSize /*= 2048 */, int padding /*= 1 */)
+    : m_PageSize(pageSize)
+    , m_Padding(padding)
+{
+}
+
+TextureAtlas::Page& TextureAtlas::AddPage(
+    const unsigned char* pixels /*= nullptr */)
+{
+  std::vector<unsigned char> clear;
+  if (!pixels)
+  {
+    clear.assign((size_t)m_PageSize * m_PageSize * 4, 0);
+    pixels = clear.data();
+  }
+  m_Pages.push_back({ std::make_unique<Texture>(m_PageSize, m_PageSize, pixels),
+      SkylinePacker(m_PageSize, m_PageSize) });
+  return m_Pages.back();
+}
+
+const AtlasRegion* TextureAtlas::Add(const std::string& filepath)
+{
+  if (const AtlasRegion* region = Find(filepath)) return region;
+
+  stbi_set_flip_vertically_on_load(1); // ogl has y=0 at the bottom
+  int width, height, channels;
+  unsigned char* pixels
+      = stbi_load(filepath.c_str(), &width, &height, &channels, 4);
+  if (!pixels)
+  {
+    std::cout << "Warning: couldn't load texture '" << filepath << "'"
+              << std::endl;
+    return nullptr;
+  }
+  const AtlasRegion* region = Add(filepath, width, height, pixels);
+  stbi_image_free(pixels);
+  return region;
+}
+
+const AtlasRegion* TextureAtlas::Add(const std::string& name, int width,
+    int height, const unsigned char* pixels)
+{
+  if (const AtlasRegion* region = Find(name)) return region;
+
+  const int paddedWidth = width + m_Padding, paddedHeight = height + m_Padding;
+  if (paddedWidth > m_PageSize || paddedHeight > m_PageSize)
+  {
+    std::cout << "Warning: '" << name << "' is bigger than an atlas page"
+              << std::endl;
+    return nullptr;
+  }
+
+  // first fit over the pages we have, a fresh one if none has room
+  int x = 0, y = 0;
+  unsigned int page = 0;
+  while (page < m_Pages.size()
+         && !m_Pages[page].Packer.Pack(paddedWidth, paddedHeight, x, y))
+    page++;
+  if (page == m_Pages.size())
+    AddPage().Packer.Pack(paddedWidth, paddedHeight, x, y);
+
+  m_Pages[page].Image->SetSubImage(x, y, width, height, pixels);
+
+  const float size = (float)m_PageSize;
+  AtlasRegion region = { page, x, y, width, height,
+    glm::vec2(x / size, y / size),
+    glm::vec2((x + width) / size, (y + height) / size) };
+  return &(m_Regions[name] = region);
+}
+
+const AtlasRegion* TextureAtlas::Find(const std::string& name) const
+{
+  auto it = m_Regions.find(name);
+  return it == m_Regions.end() ? nullptr : &it->second;
+}
+
+/*
+ * File layout, all little endian uint32 unless noted:
+ *   "OGLA" version pageSize pageCount regionCount
+ *   regionCount x { nameLength name(bytes) page x y width height }
+ *   pageCount x { nodeCount nodeCount x { x y width } pixels(RGBA8) }
+ */
+static const uint32_t AtlasMagic = 0x414c474f; // "OGLA"
+static const uint32_t AtlasVersion = 1;
+
+static void Write(std::ofstream& out, uint32_t value)
+{
+  out.write((const char*)&value, sizeof(value));
+}
+
+static uint32_t Read(std::ifstream& in)
+{
+  uint32_t value = 0;
+  in.read((char*)&value, sizeof(value));
+  return value;
+}
+
+bool TextureAtlas::Save(const std::string& filepath) const
+{
+  std::ofstream out(filepath, std::ios::binary);
+  if (!out) return false;
+
+  Write(out, AtlasMagic);
+  Write(out, AtlasVersion);
+  Write(out, m_PageSize);
+  Write(out, m_Pages.size());
+  Write(out, m_Regions.size());
+  for (const auto& [name, region] : m_Regions)
+  {
+    Write(out, name.size());
+    out.write(name.data(), name.size());
+    Write(out, region.Page);
+    Write(out, region.X);
+    Write(out, region.Y);
+    Write(out, region.Width);
+    Write(out, region.Height);
+  }
+  for (const Page& page : m_Pages)
+  {
+    const auto& skyline = page.Packer.GetSkyline();
+    Write(out, skyline.size());
+    for (const SkylinePacker::Node& node : skyline)
+    {
+      Write(out, node.X);
+      Write(out, node.Y);
+      Write(out, node.Width);
+    }
+    std::vector<unsigned char> pixels = page.Image->ReadPixels();
+    out.write((const char*)pixels.data(), pixels.size());
+  }
+  return (bool)out;
+}
+
+bool TextureAtlas::Load(const std::string& filepath)
+{
+  std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+  const uint64_t fileSize = (uint64_t)in.tellg();
+  in.seekg(0);
+  if (!in || Read(in) != AtlasMagic || Read(in) != AtlasVersion) return false;
+  // nothing read below may ask for more than is left of the file
+  auto remaining = [&] { return fileSize - (uint64_t)in.tellg(); };
+
+  int maxTextureSize = 0;
+  GLCall(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize));
+  const uint32_t pageSize = Read(in);
+  const uint32_t pageCount = Read(in), regionCount = Read(in);
+  const uint64_t pageBytes = (uint64_t)pageSize * pageSize * 4;
+  if (!in || pageSize == 0 || pageSize > (uint32_t)maxTextureSize
+      || pageCount * pageBytes > remaining()
+      || regionCount * 24ull > remaining())
+    return false;
+  m_PageSize = pageSize;
+  m_Pages.clear();
+  m_Regions.clear();
+
+  const float size = (float)m_PageSize;
+  for (uint32_t i = 0; i < regionCount && in; i++)
+  {
+    const uint32_t length = Read(in);
+    if (!in || length > remaining()) return false;
+    std::string name(length, '\0');
+    in.read(name.data(), name.size());
+    AtlasRegion region;
+    region.Page = Read(in);
+    region.X = Read(in);
+    region.Y = Read(in);
+    region.Width = Read(in);
+    region.Height = Read(in);
+    if (region.Page >= pageCount) return false;
+    region.UVMin = glm::vec2(region.X / size, region.Y / size);
+    region.UVMax = glm::vec2(
+        (region.X + region.Width) / size, (region.Y + region.Height) / size);
+    m_Regions[name] = region;
+  }
+
+  std::vector<unsigned char> pixels((size_t)m_PageSize * m_PageSize * 4);
+  for (uint32_t i = 0; i < pageCount && in; i++)
+  {
+    // a skyline never has more nodes than the page is wide
+    const uint32_t nodes = Read(in);
+    if (!in || nodes > pageSize || nodes * 12ull > remaining()) return false;
+    std::vector<SkylinePacker::Node> skyline(nodes);
+    for (SkylinePacker::Node& node : skyline)
+    {
+      node.X = Read(in);
+      node.Y = Read(in);
+      node.Width = Read(in);
+    }
+    in.read((char*)pixels.data(), pixels.size());
+    AddPage(pixels.data()).Packer.SetSkyline(skyline);
+  }
+  return (bool)in;
+}
\ No newline at end of file
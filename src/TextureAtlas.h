@@ -0,0 +1,98 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Assert.h"
+#include "Texture.h"
+
+/* Where an image ended up: which page, its pixels and its UVs on that page */
+struct AtlasRegion
+{
+  unsigned int Page;
+  int X, Y, Width, Height;
+  glm::vec2 UVMin, UVMax;
+};
+
+/*
+ * Skyline bottom-left packer. The skyline is the outline of everything
+ * packed so far as a list of horizontal segments; a new rect goes wherever
+ * it rests lowest (ties go to the narrower segment), which wastes a lot less
+ * than shelves do for mixed sizes and is cheap enough to do incrementally.
+ */
+class SkylinePacker
+{
+public:
+  struct Node
+  {
+    int X, Y, Width;
+  };
+
+private:
+  int m_Width, m_Height;
+  std::vector<Node> m_Skyline;
+
+public:
+  SkylinePacker(int width, int height);
+
+  /* false if there's no room left */
+  bool Pack(int width, int height, int& x, int& y);
+
+  inline const std::vector<Node>& GetSkyline() const { return m_Skyline; }
+  inline void SetSkyline(std::vector<Node> skyline) { m_Skyline = skyline; }
+
+private:
+  bool Fits(size_t index, int width, int height, int& y) const;
+};
+
+/*
+ * Packs many small images into a few big textures so a sprite-heavy scene
+ * stays on one texture and the BatchRenderer doesn't have to flush. Images
+ * can be added at any time; a new page opens when the current ones are full.
+ *
+ * Save() writes the pages and the region table to one file, Load() reads it
+ * back so later runs skip decoding and packing (and can keep adding).
+ */
+class TextureAtlas
+{
+private:
+  struct Page
+  {
+    std::unique_ptr<Texture> Image;
+    SkylinePacker Packer;
+  };
+
+  int m_PageSize;
+  int m_Padding;
+  std::vector<Page> m_Pages;
+  std::unordered_map<std::string, AtlasRegion> m_Regions;
+
+public:
+  TextureAtlas(int pageSize = 2048, int padding = 1);
+
+  /* Decodes `filepath` and packs it under its path. Returns the existing
+     region if it's already in, nullptr if it can't be loaded or is bigger
+     than a page. */
+  const AtlasRegion* Add(const std::string& filepath);
+  /* Same for RGBA8 pixels already in memory */
+  const AtlasRegion* Add(const std::string& name, int width, int height,
+      const unsigned char* pixels);
+
+  const AtlasRegion* Find(const std::string& name) const;
+
+  bool Save(const std::string& filepath) const;
+  bool Load(const std::string& filepath);
+
+  inline const Texture& GetPage(unsigned int page) const
+  {
+    return *m_Pages[page].Image;
+  }
+  inline unsigned int GetPageCount() const { return m_Pages.size(); }
+  inline unsigned int GetRegionCount() const { return m_Regions.size(); }
+
+private:
+  Page& AddPage(const unsigned char* pixels = nullptr);
+};
\ No newline at end of file
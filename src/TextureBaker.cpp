@@ -0,0 +1,344 @@
+#include "TextureBaker.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+using Block = unsigned char[16][4]; // 4x4 RGBA, row by row
+
+/* the 4x4 block at bx, by, edge texels repeated past the border */
+void FetchBlock(int width, int height, const unsigned char* pixels, int bx,
+    int by, Block& block)
+{
+  for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    {
+      int sx = std::min(bx * 4 + x, width - 1);
+      int sy = std::min(by * 4 + y, height - 1);
+      memcpy(block[y * 4 + x], pixels + ((size_t)sy * width + sx) * 4, 4);
+    }
+}
+
+int Distance(const unsigned char* texel, const int* color)
+{
+  int r = texel[0] - color[0], g = texel[1] - color[1], b = texel[2] - color[2];
+  return r * r + g * g + b * b;
+}
+
+uint16_t To565(const int* color)
+{
+  return (uint16_t)(((color[0] * 31 + 127) / 255) << 11
+                    | ((color[1] * 63 + 127) / 255) << 5
+                    | ((color[2] * 31 + 127) / 255));
+}
+
+void From565(uint16_t packed, int* color)
+{
+  int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+  color[0] = (r << 3) | (r >> 2);
+  color[1] = (g << 2) | (g >> 4);
+  color[2] = (b << 3) | (b >> 2);
+}
+
+/* 8 bytes: two 565 endpoints, always the four color mode, 2 bit indices */
+void EncodeBC1(const Block& block, unsigned char* out)
+{
+  int low[3] = { 255, 255, 255 }, high[3] = { 0, 0, 0 };
+  for (const auto& texel : block)
+    for (int c = 0; c < 3; c++)
+    {
+      low[c] = std::min(low[c], (int)texel[c]);
+      high[c] = std::max(high[c], (int)texel[c]);
+    }
+  // pull the endpoints in a sixteenth, a lone outlier shouldn't set the
+  // spacing of the whole palette
+  for (int c = 0; c < 3; c++)
+  {
+    int inset = (high[c] - low[c]) >> 4;
+    low[c] += inset;
+    high[c] -= inset;
+  }
+
+  uint16_t color0 = To565(high), color1 = To565(low);
+  if (color0 < color1) std::swap(color0, color1); // c0 > c1 is 4 color mode
+  int palette[4][3];
+  From565(color0, palette[0]);
+  From565(color1, palette[1]);
+  for (int c = 0; c < 3; c++)
+  {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  uint32_t indices = 0;
+  if (color0 != color1)
+    for (int i = 0; i < 16; i++)
+    {
+      int best = 0, bestError = Distance(block[i], palette[0]);
+      for (int p = 1; p < 4; p++)
+      {
+        int error = Distance(block[i], palette[p]);
+        if (error < bestError) best = p, bestError = error;
+      }
+      indices |= (uint32_t)best << (2 * i);
+    }
+
+  out[0] = color0 & 0xff;
+  out[1] = color0 >> 8;
+  out[2] = color1 & 0xff;
+  out[3] = color1 >> 8;
+  for (int i = 0; i < 4; i++)
+    out[4 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+/* 8 bytes: alpha max and min, six interpolated in between, 3 bit indices */
+void EncodeBC3Alpha(const Block& block, unsigned char* out)
+{
+  int alpha0 = 0, alpha1 = 255;
+  for (const auto& texel : block)
+  {
+    alpha0 = std::max(alpha0, (int)texel[3]);
+    alpha1 = std::min(alpha1, (int)texel[3]);
+  }
+  int palette[8] = { alpha0, alpha1 };
+  for (int i = 2; i < 8; i++)
+    palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+
+  uint64_t indices = 0;
+  if (alpha0 != alpha1)
+    for (int i = 0; i < 16; i++)
+    {
+      int best = 0, bestError = std::abs(block[i][3] - palette[0]);
+      for (int p = 1; p < 8; p++)
+      {
+        int error = std::abs(block[i][3] - palette[p]);
+        if (error < bestError) best = p, bestError = error;
+      }
+      indices |= (uint64_t)best << (3 * i);
+    }
+
+  out[0] = alpha0;
+  out[1] = alpha1;
+  for (int i = 0; i < 6; i++)
+    out[2 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+const int EtcModifiers[8][4] = {
+  { 2, 8, -2, -8 },
+  { 5, 17, -5, -17 },
+  { 9, 29, -9, -29 },
+  { 13, 42, -13, -42 },
+  { 18, 60, -18, -60 },
+  { 24, 80, -24, -80 },
+  { 33, 106, -33, -106 },
+  { 47, 183, -47, -183 },
+};
+
+struct EtcFit
+{
+  int Table;
+  int Indices[8];
+  int Error;
+};
+
+/* best modifier table for the 8 texels of a half block around `base` */
+EtcFit FitEtcHalf(const Block& block, const int* texels, const int* base)
+{
+  EtcFit best = { 0, {}, INT32_MAX };
+  for (int table = 0; table < 8; table++)
+  {
+    EtcFit fit = { table, {}, 0 };
+    for (int i = 0; i < 8; i++)
+    {
+      const unsigned char* texel = block[texels[i]];
+      int bestError = INT32_MAX;
+      for (int m = 0; m < 4; m++)
+      {
+        int color[3];
+        for (int c = 0; c < 3; c++)
+          color[c] = std::clamp(base[c] + EtcModifiers[table][m], 0, 255);
+        int error = Distance(texel, color);
+        if (error < bestError) fit.Indices[i] = m, bestError = error;
+      }
+      fit.Error += bestError;
+    }
+    if (fit.Error < best.Error) best = fit;
+  }
+  return best;
+}
+
+/*
+ * 8 bytes, big endian. Only the individual (two 444 base colors) and
+ * differential (555 plus a 333 delta) modes; a delta that stays in range
+ * never overflows, so ETC2 decoders don't see one of their extra modes.
+ */
+void EncodeETC2(const Block& block, unsigned char* out)
+{
+  uint64_t bestBits = 0;
+  int bestError = INT32_MAX;
+  for (int flip = 0; flip < 2; flip++)
+  {
+    // flip 0 is two 2x4 halves side by side, flip 1 two 4x2 stacked
+    int texels[2][8], averages[2][3] = {};
+    for (int half = 0; half < 2; half++)
+    {
+      for (int i = 0; i < 8; i++)
+      {
+        int x = flip ? i % 4 : half * 2 + i % 2;
+        int y = flip ? half * 2 + i / 4 : i / 2;
+        texels[half][i] = y * 4 + x;
+        for (int c = 0; c < 3; c++)
+          averages[half][c] += block[y * 4 + x][c];
+      }
+    }
+
+    for (int differential = 1; differential >= 0; differential--)
+    {
+      int quantized[2][3], bases[2][3];
+      bool fits = true;
+      for (int half = 0; half < 2; half++)
+        for (int c = 0; c < 3; c++)
+        {
+          // the average of 8 texels, rounded to 5 or 4 bits
+          int levels = differential ? 31 : 15;
+          int q = (averages[half][c] * levels + 255 * 4) / (255 * 8);
+          quantized[half][c] = q;
+          bases[half][c] = differential ? (q << 3) | (q >> 2) : (q << 4) | q;
+        }
+      for (int c = 0; c < 3 && differential; c++)
+      {
+        int delta = quantized[1][c] - quantized[0][c];
+        fits = fits && delta >= -4 && delta <= 3;
+      }
+      if (!fits) continue;
+
+      EtcFit halves[2] = { FitEtcHalf(block, texels[0], bases[0]),
+        FitEtcHalf(block, texels[1], bases[1]) };
+      int error = halves[0].Error + halves[1].Error;
+      if (error >= bestError) continue;
+
+      uint64_t bits = 0;
+      for (int c = 0; c < 3; c++)
+      {
+        int shift = 59 - c * 8; // R at 63, G at 55, B at 47
+        if (differential)
+        {
+          int delta = quantized[1][c] - quantized[0][c];
+          bits |= (uint64_t)quantized[0][c] << shift;
+          bits |= (uint64_t)(delta & 7) << (shift - 3);
+        }
+        else
+        {
+          bits |= (uint64_t)quantized[0][c] << (shift + 1);
+          bits |= (uint64_t)quantized[1][c] << (shift - 3);
+        }
+      }
+      bits |= (uint64_t)halves[0].Table << 37;
+      bits |= (uint64_t)halves[1].Table << 34;
+      bits |= (uint64_t)differential << 33;
+      bits |= (uint64_t)flip << 32;
+      // texel x, y is bit x * 4 + y, index msb in the upper 16
+      for (int half = 0; half < 2; half++)
+        for (int i = 0; i < 8; i++)
+        {
+          int texel = texels[half][i];
+          int bit = (texel % 4) * 4 + texel / 4;
+          int index = halves[half].Indices[i];
+          bits |= (uint64_t)(index >> 1) << (16 + bit);
+          bits |= (uint64_t)(index & 1) << bit;
+        }
+      bestBits = bits;
+      bestError = error;
+    }
+  }
+  for (int i = 0; i < 8; i++)
+    out[i] = (bestBits >> (56 - 8 * i)) & 0xff;
+}
+}
+
+bool TextureBaker::Bake(const std::string& filepath, TextureFormat format,
+    int width, int height, const unsigned char* pixels,
+    bool mipmaps /*= true */)
+{
+  std::vector<std::vector<unsigned char>> levels;
+  std::vector<unsigned char> level(pixels, pixels + (size_t)width * height * 4);
+  int levelWidth = width, levelHeight = height;
+  for (;;)
+  {
+    levels.push_back(Encode(format, levelWidth, levelHeight, level.data()));
+    if (!mipmaps || (levelWidth == 1 && levelHeight == 1)
+        || levels.size() == TextureFile::MaxLevels)
+      break;
+    level = Downsample(levelWidth, levelHeight, level.data());
+    levelWidth = std::max(levelWidth / 2, 1);
+    levelHeight = std::max(levelHeight / 2, 1);
+  }
+  return TextureFile::Write(filepath, format, width, height, levels);
+}
+
+std::vector<unsigned char> TextureBaker::Encode(TextureFormat format,
+    int width, int height, const unsigned char* pixels)
+{
+  if (format == TextureFormat::RGBA8)
+    return std::vector<unsigned char>(
+        pixels, pixels + (size_t)width * height * 4);
+
+  std::vector<unsigned char> out(
+      TextureFile::GetLevelSize(format, width, height));
+  unsigned char* cursor = out.data();
+  Block block;
+  for (int by = 0; by < (height + 3) / 4; by++)
+    for (int bx = 0; bx < (width + 3) / 4; bx++)
+    {
+      FetchBlock(width, height, pixels, bx, by, block);
+      switch (format)
+      {
+        case TextureFormat::BC1: EncodeBC1(block, cursor); break;
+        case TextureFormat::BC3:
+          EncodeBC3Alpha(block, cursor);
+          EncodeBC1(block, cursor + 8);
+          break;
+        case TextureFormat::ETC2: EncodeETC2(block, cursor); break;
+        case TextureFormat::RGBA8: break;
+      }
+      cursor += format == TextureFormat::BC3 ? 16 : 8;
+    }
+  return out;
+}
+
+std::vector<unsigned char> TextureBaker::Downsample(
+    int width, int height, const unsigned char* pixels)
+{
+  const int halfWidth = std::max(width / 2, 1);
+  const int halfHeight = std::max(height / 2, 1);
+  std::vector<unsigned char> out((size_t)halfWidth * halfHeight * 4);
+  for (int y = 0; y < halfHeight; y++)
+    for (int x = 0; x < halfWidth; x++)
+    {
+      int x0 = x * 2, x1 = std::min(x * 2 + 1, width - 1);
+      int y0 = y * 2, y1 = std::min(y * 2 + 1, height - 1);
+      const unsigned char* texels[4] = {
+        pixels + ((size_t)y0 * width + x0) * 4,
+        pixels + ((size_t)y0 * width + x1) * 4,
+        pixels + ((size_t)y1 * width + x0) * 4,
+        pixels + ((size_t)y1 * width + x1) * 4,
+      };
+      for (int c = 0; c < 4; c++)
+        out[((size_t)y * halfWidth + x) * 4 + c] = (texels[0][c] + texels[1][c]
+                                                        + texels[2][c]
+                                                        + texels[3][c] + 2)
+                                                   / 4;
+    }
+  return out;
+}
+
+bool TextureBaker::HasAlpha(
+    int width, int height, const unsigned char* pixels)
+{
+  for (size_t i = 0; i < (size_t)width * height; i++)
+    if (pixels[i * 4 + 3] != 255) return true;
+  return false;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "TextureFile.h"
+
+/*
+ * The offline half of TextureFile, CPU only so the texbake tool doesn't need
+ * a context. Mips are a 2x2 box filter all the way down to 1x1. The block
+ * encoders go for speed over quality: BC1/BC3 fit the endpoints to each
+ * block's bounding box, ETC2 only emits the ETC1 compatible individual and
+ * differential modes, searching both flips and every modifier table.
+ */
+class TextureBaker
+{
+public:
+  /* RGBA8 `pixels`, rows bottom first. Writes the file, false on failure. */
+  static bool Bake(const std::string& filepath, TextureFormat format,
+      int width, int height, const unsigned char* pixels,
+      bool mipmaps = true);
+
+  /* RGBA8 in, one level of `format` out */
+  static std::vector<unsigned char> Encode(TextureFormat format, int width,
+      int height, const unsigned char* pixels);
+  /* half the size (rounding down, never below 1) */
+  static std::vector<unsigned char> Downsample(
+      int width, int height, const unsigned char* pixels);
+
+  static bool HasAlpha(int width, int height, const unsigned char* pixels);
+};
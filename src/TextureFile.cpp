@@ -0,0 +1,129 @@
+#include "TextureFile.h"
+
+#include <algorithm>
+#include <fstream>
+
+static const uint32_t TextureMagic = 0x544c474f; // "OGLT"
+static const uint32_t TextureVersion = 1;
+
+struct TextureFileHeader
+{
+  uint32_t Magic, Version, Format, Width, Height, LevelCount;
+};
+
+struct TextureFileLevel
+{
+  uint32_t Width, Height, Offset, Size;
+};
+
+static uint32_t AlignUp(uint32_t value) { return (value + 15) & ~15u; }
+
+TextureFile::TextureFile()
+    : m_Format(TextureFormat::RGBA8)
+    , m_Levels {}
+    , m_LevelCount(0)
+{
+}
+
+bool TextureFile::Open(const std::string& filepath)
+{
+  m_LevelCount = 0;
+  if (!m_File.Open(filepath)) return false;
+  return Open(std::span(m_File.GetData(), m_File.GetSize()));
+}
+
+bool TextureFile::Open(std::span<const unsigned char> file)
+{
+  m_LevelCount = 0;
+  if (file.size() < sizeof(TextureFileHeader)) return false;
+
+  const unsigned char* data = file.data();
+  const size_t size = file.size();
+  const auto* header = (const TextureFileHeader*)data;
+  if (header->Magic != TextureMagic || header->Version != TextureVersion
+      || header->Format > (uint32_t)TextureFormat::ETC2
+      || header->LevelCount == 0 || header->LevelCount > MaxLevels
+      || header->Width == 0 || header->Width > MaxSize
+      || header->Height == 0 || header->Height > MaxSize
+      || sizeof(TextureFileHeader)
+                 + header->LevelCount * sizeof(TextureFileLevel)
+             > size)
+    return false;
+
+  m_Format = (TextureFormat)header->Format;
+  const auto* levels = (const TextureFileLevel*)(header + 1);
+  for (uint32_t i = 0; i < header->LevelCount; i++)
+  {
+    const TextureFileLevel& level = levels[i];
+    // each level is the one above halved, down to 1, as GL expects a chain
+    if (level.Width != std::max(header->Width >> i, 1u)
+        || level.Height != std::max(header->Height >> i, 1u)
+        || (size_t)level.Offset + level.Size > size
+        || level.Size != GetLevelSize(m_Format, level.Width, level.Height))
+      return false;
+    m_Levels[i] = { level.Width, level.Height, data + level.Offset,
+      level.Size };
+  }
+  m_LevelCount = header->LevelCount;
+  return true;
+}
+
+bool TextureFile::Write(const std::string& filepath, TextureFormat format,
+    int width, int height,
+    const std::vector<std::vector<unsigned char>>& levels)
+{
+  if (levels.empty() || levels.size() > MaxLevels) return false;
+
+  TextureFileHeader header = { TextureMagic, TextureVersion, (uint32_t)format,
+    (uint32_t)width, (uint32_t)height, (uint32_t)levels.size() };
+  std::vector<TextureFileLevel> table(levels.size());
+  uint32_t offset = AlignUp(
+      sizeof(TextureFileHeader) + levels.size() * sizeof(TextureFileLevel));
+  for (size_t i = 0; i < levels.size(); i++)
+  {
+    table[i] = { (uint32_t)width, (uint32_t)height, offset,
+      (uint32_t)levels[i].size() };
+    if (table[i].Size != GetLevelSize(format, width, height)) return false;
+    offset = AlignUp(offset + table[i].Size);
+    width = std::max(width / 2, 1);
+    height = std::max(height / 2, 1);
+  }
+
+  std::ofstream out(filepath, std::ios::binary);
+  if (!out) return false;
+  out.write((const char*)&header, sizeof(header));
+  out.write((const char*)table.data(), table.size() * sizeof(table[0]));
+  for (size_t i = 0; i < levels.size(); i++)
+  {
+    while ((uint32_t)out.tellp() < table[i].Offset)
+      out.put(0);
+    out.write((const char*)levels[i].data(), levels[i].size());
+  }
+  return (bool)out;
+}
+
+uint32_t TextureFile::GetLevelSize(
+    TextureFormat format, int width, int height)
+{
+  const uint32_t blocks = ((width + 3) / 4) * ((height + 3) / 4);
+  switch (format)
+  {
+    case TextureFormat::RGBA8: return (uint32_t)width * height * 4;
+    case TextureFormat::BC1: return blocks * 8;
+    case TextureFormat::BC3: return blocks * 16;
+    case TextureFormat::ETC2: return blocks * 8;
+  }
+  return 0;
+}
+
+const char* TextureFile::GetFormatName(TextureFormat format)
+{
+  switch (format)
+  {
+    case TextureFormat::RGBA8: return "rgba8";
+    case TextureFormat::BC1: return "bc1";
+    case TextureFormat::BC3: return "bc3";
+    case TextureFormat::ETC2: return "etc2";
+  }
+  return "unknown";
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/* How the texels of a baked texture are stored. BC1 and ETC2 are 8 bytes
+   per 4x4 block (RGB, alpha dropped), BC3 is 16 (RGBA). */
+enum class TextureFormat : uint32_t
+{
+  RGBA8 = 0,
+  BC1 = 1,
+  BC3 = 2,
+  ETC2 = 3,
+};
+
+struct TextureLevel
+{
+  uint32_t Width, Height;
+  const unsigned char* Data; // into the mapping
+  uint32_t Size;
+};
+
+/*
+ * The GPU ready container texbake writes: a small header and every mip
+ * level, already in the format it's uploaded in, rows bottom first like
+ * stb_image hands them to Texture. The whole thing is mapped and the level
+ * pointers go straight to glTexImage2D/glCompressedTexImage2D.
+ *
+ *   "OGLT" version format width height levelCount
+ *   levelCount x { width height offset size }
+ *   level data, each starting 16 byte aligned
+ */
+class TextureFile
+{
+public:
+  static const unsigned int MaxLevels = 16; // 32768 square and down
+  static const unsigned int MaxSize = 1 << (MaxLevels - 1);
+
+private:
+  MappedFile m_File;
+  TextureFormat m_Format;
+  std::array<TextureLevel, MaxLevels> m_Levels;
+  unsigned int m_LevelCount;
+
+public:
+  TextureFile();
+
+  /* Maps `filepath` and checks it over, false if it's anything but a
+     texture file texbake wrote (a png, say) */
+  bool Open(const std::string& filepath);
+  /* same for a file already in memory, e.g. out of a ResourcePack; the
+     levels point into `file`, which has to outlive them */
+  bool Open(std::span<const unsigned char> file);
+
+  /* `levels` from the biggest down, each exactly GetLevelSize() bytes */
+  static bool Write(const std::string& filepath, TextureFormat format,
+      int width, int height,
+      const std::vector<std::vector<unsigned char>>& levels);
+
+  /* bytes a width x height level takes in `format` */
+  static uint32_t GetLevelSize(TextureFormat format, int width, int height);
+  static const char* GetFormatName(TextureFormat format);
+
+  inline TextureFormat GetFormat() const { return m_Format; }
+  inline unsigned int GetLevelCount() const { return m_LevelCount; }
+  inline const TextureLevel& GetLevel(unsigned int level) const
+  {
+    return m_Levels[level];
+  }
+  inline int GetWidth() const { return m_Levels[0].Width; }
+  inline int GetHeight() const { return m_Levels[0].Height; }
+};
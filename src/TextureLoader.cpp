@@ -0,0 +1,108 @@
+#include "TextureLoader.h"
+
+#include <cstring>
+
+#include "ResourcePack.h"
+
+TextureLoader::TextureLoader(
+    size_t uploadBudget /*= 8 MiB */, unsigned int threads /*= 0 */)
+    : m_Pool(threads)
+    , m_Pending(0)
+    , m_PixelBuffer(0)
+    , m_UploadBudget(uploadBudget)
+{
+  GLCall(glGenBuffers(1, &m_PixelBuffer));
+}
+
+TextureLoader::~TextureLoader()
+{
+  m_Pool.Wait();
+  for (Decoded& image : m_Decoded)
+    stbi_image_free(image.Pixels);
+  GLState::ForgetBuffer(m_PixelBuffer);
+  GLCall(glDeleteBuffers(1, &m_PixelBuffer));
+}
+
+std::shared_ptr<Texture> TextureLoader::Load(const std::string& filepath)
+{
+  std::shared_ptr<Texture> texture = Texture::CreatePlaceholder();
+  m_Pending++;
+  m_Pool.Submit([this, target = std::weak_ptr<Texture>(texture), filepath] {
+    // the flip flag is per thread since stb_image 2.24
+    stbi_set_flip_vertically_on_load_thread(1);
+    Decoded image = { target, 0, 0, nullptr };
+    int channels;
+    std::span<const unsigned char> packed = ResourcePack::Lookup(filepath);
+    if (packed.empty())
+      image.Pixels = stbi_load(
+          filepath.c_str(), &image.Width, &image.Height, &channels, 4);
+    else
+      image.Pixels = stbi_load_from_memory(packed.data(), (int)packed.size(),
+          &image.Width, &image.Height, &channels, 4);
+    if (!image.Pixels)
+    {
+      std::cout << "Warning: couldn't load texture '" << filepath
+                << "': " << stbi_failure_reason() << std::endl;
+      m_Pending--;
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Decoded.push_back(image);
+  });
+  return texture;
+}
+
+size_t TextureLoader::Update()
+{
+  size_t uploaded = 0;
+  while (uploaded == 0 || uploaded < m_UploadBudget)
+  {
+    Decoded image;
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (m_Decoded.empty()) break;
+      image = m_Decoded.front();
+      m_Decoded.pop_front();
+    }
+    // nobody wanted it in the meantime, the upload would be wasted
+    if (std::shared_ptr<Texture> target = image.Target.lock())
+    {
+      Upload(*target, image);
+      uploaded += (size_t)image.Width * image.Height * 4;
+    }
+    stbi_image_free(image.Pixels);
+    m_Pending--;
+  }
+  return uploaded;
+}
+
+void TextureLoader::Finish()
+{
+  while (m_Pending)
+  {
+    m_Pool.Wait();
+    Update();
+  }
+}
+
+void TextureLoader::Upload(Texture& target, const Decoded& image)
+{
+  const size_t size = (size_t)image.Width * image.Height * 4;
+
+  // orphan the old storage so we never wait on the previous upload, then
+  // write straight into memory the driver can DMA from
+  GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PixelBuffer);
+  GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+  GLCall(void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+  if (mapped)
+  {
+    memcpy(mapped, image.Pixels, size);
+    GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+    target.SetImage(image.Width, image.Height, nullptr); // offset 0
+  }
+  GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  // couldn't map, go the slow way
+  if (!mapped) target.SetImage(image.Width, image.Height, image.Pixels);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Assert.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+
+/*
+ * Streams textures in without stalling the frame. Load() returns a
+ * placeholder right away and queues the file on the worker pool, which does
+ * the stb_image decode. Update(), called once a frame on the GL thread,
+ * copies finished images into a pixel buffer object and points
+ * glTexImage2D at it, until the frame's byte budget is used up.
+ *
+ * At least one image goes up per Update() even if it's bigger than the
+ * budget, otherwise a huge texture would never make it.
+ */
+class TextureLoader
+{
+private:
+  /* Workers only ever hold the texture weakly: whoever drops the last
+     reference deletes it, and that has to be the GL thread. */
+  struct Decoded
+  {
+    std::weak_ptr<Texture> Target;
+    int Width, Height;
+    unsigned char* Pixels; // stb_image owned
+  };
+
+  ThreadPool m_Pool;
+  std::mutex m_Mutex;
+  std::deque<Decoded> m_Decoded;
+  std::atomic<unsigned int> m_Pending; // queued or decoding or not uploaded
+  unsigned int m_PixelBuffer;
+  size_t m_UploadBudget;
+
+public:
+  TextureLoader(
+      size_t uploadBudget = 8 * 1024 * 1024, unsigned int threads = 0);
+  ~TextureLoader();
+
+  std::shared_ptr<Texture> Load(const std::string& filepath);
+
+  /* GL thread only. Returns the number of bytes uploaded. */
+  size_t Update();
+  /* Blocks until every queued texture has been decoded and uploaded. */
+  void Finish();
+
+  inline unsigned int GetPendingCount() const { return m_Pending; }
+  inline void SetUploadBudget(size_t bytes) { m_UploadBudget = bytes; }
+
+private:
+  void Upload(Texture& target, const Decoded& image);
+};
\ No newline at end of file
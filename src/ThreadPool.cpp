@@ -0,0 +1,73 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threads /*= 0 */)
+    : m_Next(0)
+    , m_Busy(0)
+    , m_Stopping(false)
+{
+  if (threads == 0)
+  {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    threads = hardware > 1 ? hardware - 1 : 1;
+  }
+  for (unsigned int i = 0; i < threads; i++)
+    m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_WorkAvailable.notify_all();
+  for (std::thread& worker : m_Workers)
+    worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Queue.push_back(std::move(job));
+  }
+  m_WorkAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_Idle.wait(lock, [this] { return !HasWork() && m_Busy == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_WorkAvailable.wait(
+          lock, [this] { return m_Stopping || HasWork(); });
+      if (m_Stopping && !HasWork()) return;
+      job = std::move(m_Queue[m_Next++]);
+      // drop what's been taken once it's most of the vector, or a pool
+      // that never runs dry grows it forever. Moving the rest down costs no
+      // more than what was taken, and erase keeps the capacity.
+      if (m_Next * 2 > m_Queue.size())
+      {
+        m_Queue.erase(m_Queue.begin(), m_Queue.begin() + m_Next);
+        m_Next = 0;
+      }
+      m_Busy++;
+    }
+
+    job();
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Busy--;
+      if (m_Busy == 0 && !HasWork()) m_Idle.notify_all();
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Plain fixed-size pool of worker threads pulling std::functions off one
+ * queue. Nothing in here may touch GL, the context only lives on the main
+ * thread.
+ */
+class ThreadPool
+{
+private:
+  std::vector<std::thread> m_Workers;
+  // a vector and a read index rather than a deque, so a steady stream of
+  // jobs reuses the same storage instead of allocating blocks as it goes
+  std::vector<std::function<void()>> m_Queue;
+  size_t m_Next;
+  std::mutex m_Mutex;
+  std::condition_variable m_WorkAvailable;
+  std::condition_variable m_Idle;
+  unsigned int m_Busy;
+  bool m_Stopping;
+
+public:
+  /* 0 threads = one per hardware thread, less the main one */
+  ThreadPool(unsigned int threads = 0);
+  ~ThreadPool();
+
+  void Submit(std::function<void()> job);
+  /* blocks until the queue is empty and every worker is done */
+  void Wait();
+
+  inline unsigned int GetThreadCount() const { return m_Workers.size(); }
+
+private:
+  inline bool HasWork() const { return m_Next < m_Queue.size(); }
+  void WorkerLoop();
+};
\ No newline at end of file
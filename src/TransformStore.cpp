@@ -0,0 +1,262 @@
+#include "TransformStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Profiler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define TRANSFORM_SSE
+#include <immintrin.h>
+#endif
+#if defined(TRANSFORM_SSE) && defined(__AVX__)
+#define TRANSFORM_AVX
+#endif
+
+namespace
+{
+// every array is padded to this, so a block never runs off the end
+const unsigned int BlockSize = 8;
+
+#ifdef TRANSFORM_SSE
+inline __m128 Load(const float* p) { return _mm_loadu_ps(p); }
+inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+inline __m128 One(__m128) { return _mm_set1_ps(1.0f); }
+#endif
+#ifdef TRANSFORM_AVX
+inline __m256 Load8(const float* p) { return _mm256_loadu_ps(p); }
+inline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+inline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+inline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+inline __m256 One(__m256) { return _mm256_set1_ps(1.0f); }
+#endif
+
+/* The upper 3x3 of translate * mat4_cast(q) * scale, one lane per entity.
+   Out is column major: c[0..2] is the first column. */
+template <typename V>
+inline void RotationScale(V x, V y, V z, V w, V sx, V sy, V sz, V* c)
+{
+  V x2 = Add(x, x), y2 = Add(y, y), z2 = Add(z, z);
+  V xx = Mul(x, x2), yy = Mul(y, y2), zz = Mul(z, z2);
+  V xy = Mul(x, y2), xz = Mul(x, z2), yz = Mul(y, z2);
+  V wx = Mul(w, x2), wy = Mul(w, y2), wz = Mul(w, z2);
+  V one = One(x);
+
+  c[0] = Mul(Sub(one, Add(yy, zz)), sx);
+  c[1] = Mul(Add(xy, wz), sx);
+  c[2] = Mul(Sub(xz, wy), sx);
+  c[3] = Mul(Sub(xy, wz), sy);
+  c[4] = Mul(Sub(one, Add(xx, zz)), sy);
+  c[5] = Mul(Add(yz, wx), sy);
+  c[6] = Mul(Add(xz, wy), sz);
+  c[7] = Mul(Sub(yz, wx), sz);
+  c[8] = Mul(Sub(one, Add(xx, yy)), sz);
+}
+
+#ifdef TRANSFORM_SSE
+/* Turns four entities' worth of lanes into four mat4 columns each. The
+   registers hold one component for all four, a transpose makes each one
+   hold one entity's column. */
+inline void StoreModels4(const __m128* c, __m128 px, __m128 py, __m128 pz,
+    TransformInstance* out)
+{
+  __m128 zero0 = _mm_setzero_ps(), zero1 = zero0, zero2 = zero0;
+  __m128 one = _mm_set1_ps(1.0f);
+  __m128 c0x = c[0], c0y = c[1], c0z = c[2];
+  __m128 c1x = c[3], c1y = c[4], c1z = c[5];
+  __m128 c2x = c[6], c2y = c[7], c2z = c[8];
+  _MM_TRANSPOSE4_PS(c0x, c0y, c0z, zero0);
+  _MM_TRANSPOSE4_PS(c1x, c1y, c1z, zero1);
+  _MM_TRANSPOSE4_PS(c2x, c2y, c2z, zero2);
+  _MM_TRANSPOSE4_PS(px, py, pz, one);
+
+  const __m128 columns[4][4] = { { c0x, c1x, c2x, px }, { c0y, c1y, c2y, py },
+    { c0z, c1z, c2z, pz }, { zero0, zero1, zero2, one } };
+  for (int e = 0; e < 4; e++)
+  {
+    float* model = &out[e].Model[0][0];
+    for (int column = 0; column < 4; column++)
+      _mm_storeu_ps(model + column * 4, columns[e][column]);
+  }
+}
+#endif
+}
+
+TransformStore::TransformStore(unsigned int capacity)
+    : m_Capacity(capacity)
+    , m_Count(0)
+    , m_UploadBegin(0)
+    , m_UploadEnd(0)
+    , m_InstanceBuffer(capacity * sizeof(TransformInstance))
+{
+  const unsigned int padded
+      = (capacity + BlockSize - 1) / BlockSize * BlockSize;
+  for (std::vector<float>* component : { &m_PositionX, &m_PositionY,
+           &m_PositionZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_ScaleX,
+           &m_ScaleY, &m_ScaleZ })
+    component->assign(padded, 0.0f);
+  m_RotationW.assign(padded, 1.0f);
+  m_Tints.assign(padded, glm::vec4(1.0f));
+  m_Dirty.assign(padded, 0);
+  m_Instances.assign(padded, { glm::mat4(1.0f), glm::vec4(1.0f) });
+}
+
+Entity TransformStore::Create(const glm::vec3& position,
+    const glm::quat& rotation, const glm::vec3& scale, const glm::vec4& tint)
+{
+  ASSERT(m_Count < m_Capacity);
+  Entity entity = m_Count++;
+  SetPosition(entity, position);
+  SetRotation(entity, rotation);
+  SetScale(entity, scale);
+  SetTint(entity, tint);
+  return entity;
+}
+
+unsigned int TransformStore::Update()
+{
+  PROFILE_SCOPE("Transforms");
+  unsigned int updated = UpdateTransforms();
+  Upload();
+  return updated;
+}
+
+unsigned int TransformStore::UpdateTransforms()
+{
+  unsigned int updated = 0;
+  unsigned int first = m_Count, last = 0;
+
+  // whole blocks at a time: if any flag in one is set the entire block gets
+  // rebuilt, it costs the same as one entity
+  for (unsigned int i = 0; i < m_Count; i += BlockSize)
+  {
+    uint64_t flags;
+    memcpy(&flags, &m_Dirty[i], sizeof(flags));
+    if (!flags) continue;
+    // flags are 0 or 1 a byte, this sums the bytes into the top one
+    updated += (unsigned int)((flags * 0x0101010101010101ull) >> 56);
+
+    ComputeModels8(i);
+    for (unsigned int e = i; e < i + BlockSize; e++)
+      m_Instances[e].Tint = m_Tints[e];
+    memset(&m_Dirty[i], 0, BlockSize);
+    first = std::min(first, i);
+    last = i + BlockSize;
+  }
+
+  if (updated)
+  {
+    last = std::min(last, m_Count);
+    m_UploadBegin = m_UploadBegin < m_UploadEnd ? std::min(m_UploadBegin, first)
+                                                : first;
+    m_UploadEnd = std::max(m_UploadEnd, last);
+  }
+  return updated;
+}
+
+void TransformStore::Upload()
+{
+  if (m_UploadBegin >= m_UploadEnd) return;
+  m_InstanceBuffer.SetData(&m_Instances[m_UploadBegin],
+      (m_UploadEnd - m_UploadBegin) * sizeof(TransformInstance),
+      m_UploadBegin * sizeof(TransformInstance));
+  m_UploadBegin = m_UploadEnd = 0;
+}
+
+void TransformStore::ComputeMVPs(
+    const glm::mat4& viewProjection, glm::mat4* out) const
+{
+#ifdef TRANSFORM_SSE
+  const __m128 vp0 = _mm_loadu_ps(&viewProjection[0][0]);
+  const __m128 vp1 = _mm_loadu_ps(&viewProjection[1][0]);
+  const __m128 vp2 = _mm_loadu_ps(&viewProjection[2][0]);
+  const __m128 vp3 = _mm_loadu_ps(&viewProjection[3][0]);
+  for (unsigned int i = 0; i < m_Count; i++)
+  {
+    const float* model = &m_Instances[i].Model[0][0];
+    float* mvp = &out[i][0][0];
+    // column j of the result is viewProjection times column j of the model
+    for (int column = 0; column < 4; column++)
+    {
+      const float* m = model + column * 4;
+      __m128 r = _mm_mul_ps(vp0, _mm_set1_ps(m[0]));
+      r = _mm_add_ps(r, _mm_mul_ps(vp1, _mm_set1_ps(m[1])));
+      r = _mm_add_ps(r, _mm_mul_ps(vp2, _mm_set1_ps(m[2])));
+      r = _mm_add_ps(r, _mm_mul_ps(vp3, _mm_set1_ps(m[3])));
+      _mm_storeu_ps(mvp + column * 4, r);
+    }
+  }
+#else
+  for (unsigned int i = 0; i < m_Count; i++)
+    out[i] = viewProjection * m_Instances[i].Model;
+#endif
+}
+
+/* Scalar version of the blocks below, for targets without SSE. The 8 wide
+   block falls back to two 4 wide ones without AVX, and those to this. */
+void TransformStore::ComputeModel(unsigned int i)
+{
+  float c[9];
+  float x = m_RotationX[i], y = m_RotationY[i], z = m_RotationZ[i];
+  float w = m_RotationW[i];
+  float xx = 2 * x * x, yy = 2 * y * y, zz = 2 * z * z;
+  float xy = 2 * x * y, xz = 2 * x * z, yz = 2 * y * z;
+  float wx = 2 * w * x, wy = 2 * w * y, wz = 2 * w * z;
+  c[0] = (1 - (yy + zz)) * m_ScaleX[i];
+  c[1] = (xy + wz) * m_ScaleX[i];
+  c[2] = (xz - wy) * m_ScaleX[i];
+  c[3] = (xy - wz) * m_ScaleY[i];
+  c[4] = (1 - (xx + zz)) * m_ScaleY[i];
+  c[5] = (yz + wx) * m_ScaleY[i];
+  c[6] = (xz + wy) * m_ScaleZ[i];
+  c[7] = (yz - wx) * m_ScaleZ[i];
+  c[8] = (1 - (xx + yy)) * m_ScaleZ[i];
+
+  glm::mat4& model = m_Instances[i].Model;
+  for (int column = 0; column < 3; column++)
+    model[column] = glm::vec4(
+        c[column * 3], c[column * 3 + 1], c[column * 3 + 2], 0.0f);
+  model[3] = glm::vec4(m_PositionX[i], m_PositionY[i], m_PositionZ[i], 1.0f);
+}
+
+void TransformStore::ComputeModels4(unsigned int i)
+{
+#ifdef TRANSFORM_SSE
+  __m128 c[9];
+  RotationScale(Load(&m_RotationX[i]), Load(&m_RotationY[i]),
+      Load(&m_RotationZ[i]), Load(&m_RotationW[i]), Load(&m_ScaleX[i]),
+      Load(&m_ScaleY[i]), Load(&m_ScaleZ[i]), c);
+  StoreModels4(c, Load(&m_PositionX[i]), Load(&m_PositionY[i]),
+      Load(&m_PositionZ[i]), &m_Instances[i]);
+#else
+  for (unsigned int e = i; e < i + 4; e++)
+    ComputeModel(e);
+#endif
+}
+
+void TransformStore::ComputeModels8(unsigned int i)
+{
+#ifdef TRANSFORM_AVX
+  __m256 c[9];
+  RotationScale(Load8(&m_RotationX[i]), Load8(&m_RotationY[i]),
+      Load8(&m_RotationZ[i]), Load8(&m_RotationW[i]), Load8(&m_ScaleX[i]),
+      Load8(&m_ScaleY[i]), Load8(&m_ScaleZ[i]), c);
+
+  // the transpose is done 4 wide, so split each register in halves
+  __m128 low[9], high[9];
+  for (int k = 0; k < 9; k++)
+  {
+    low[k] = _mm256_castps256_ps128(c[k]);
+    high[k] = _mm256_extractf128_ps(c[k], 1);
+  }
+  StoreModels4(low, Load(&m_PositionX[i]), Load(&m_PositionY[i]),
+      Load(&m_PositionZ[i]), &m_Instances[i]);
+  StoreModels4(high, Load(&m_PositionX[i + 4]), Load(&m_PositionY[i + 4]),
+      Load(&m_PositionZ[i + 4]), &m_Instances[i + 4]);
+#else
+  ComputeModels4(i);
+  ComputeModels4(i + 4);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "Assert.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+/* What instanced.shader reads per instance, locations 2 through 6 */
+struct TransformInstance
+{
+  glm::mat4 Model;
+  glm::vec4 Tint;
+};
+
+template <> struct VertexFormat<TransformInstance>
+{
+  static constexpr auto Layout = MakeInstanceLayout<TransformInstance>(
+      VERTEX_ATTRIBUTE(TransformInstance, Model),
+      VERTEX_ATTRIBUTE(TransformInstance, Tint));
+};
+
+using Entity = unsigned int;
+
+/*
+ * Position, rotation and scale for lots of objects, kept as one array per
+ * component (struct of arrays) so the update pass can load four or eight
+ * entities' worth of the same component into one SSE/AVX register and build
+ * all their model matrices at once.
+ *
+ * Setters only flag the entity. Update() rebuilds the model matrix of
+ * everything flagged, straight into the instance data, and uploads the range
+ * that changed to an instance buffer the renderer can draw from as is:
+ *
+ *   va.AddBuffer<TransformInstance>(store.GetInstanceBuffer());
+ *   renderer.DrawInstanced(va, ib, shader, store.GetCount());
+ *
+ * The view projection stays on the GPU (the Camera block), otherwise every
+ * camera move would flag every entity. ComputeMVPs() is there for CPU side
+ * users that want them anyway.
+ */
+class TransformStore
+{
+private:
+  unsigned int m_Capacity;
+  unsigned int m_Count;
+
+  // padded to a whole number of SIMD blocks, the padding is never dirty
+  std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+  std::vector<float> m_RotationX, m_RotationY, m_RotationZ, m_RotationW;
+  std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+  std::vector<glm::vec4> m_Tints;
+  std::vector<uint8_t> m_Dirty;
+
+  std::vector<TransformInstance> m_Instances;
+  unsigned int m_UploadBegin, m_UploadEnd; // instances rebuilt since Upload()
+  VertexBuffer m_InstanceBuffer;
+
+public:
+  TransformStore(unsigned int capacity);
+
+  Entity Create(const glm::vec3& position,
+      const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+      const glm::vec3& scale = glm::vec3(1.0f),
+      const glm::vec4& tint = glm::vec4(1.0f));
+
+  inline void SetPosition(Entity entity, const glm::vec3& position)
+  {
+    m_PositionX[entity] = position.x;
+    m_PositionY[entity] = position.y;
+    m_PositionZ[entity] = position.z;
+    m_Dirty[entity] = 1;
+  }
+  inline void SetRotation(Entity entity, const glm::quat& rotation)
+  {
+    m_RotationX[entity] = rotation.x;
+    m_RotationY[entity] = rotation.y;
+    m_RotationZ[entity] = rotation.z;
+    m_RotationW[entity] = rotation.w;
+    m_Dirty[entity] = 1;
+  }
+  inline void SetScale(Entity entity, const glm::vec3& scale)
+  {
+    m_ScaleX[entity] = scale.x;
+    m_ScaleY[entity] = scale.y;
+    m_ScaleZ[entity] = scale.z;
+    m_Dirty[entity] = 1;
+  }
+  inline void SetTint(Entity entity, const glm::vec4& tint)
+  {
+    m_Tints[entity] = tint;
+    m_Dirty[entity] = 1;
+  }
+
+  inline glm::vec3 GetPosition(Entity entity) const
+  {
+    return glm::vec3(
+        m_PositionX[entity], m_PositionY[entity], m_PositionZ[entity]);
+  }
+  inline const glm::mat4& GetModel(Entity entity) const
+  {
+    return m_Instances[entity].Model;
+  }
+
+  /* UpdateTransforms() then Upload(), returns how many were rebuilt */
+  unsigned int Update();
+  /* CPU half of Update(): rebuilds dirty model matrices, clears the flags */
+  unsigned int UpdateTransforms();
+  /* sends whatever UpdateTransforms() rewrote to the instance buffer */
+  void Upload();
+
+  /* viewProjection * model for every entity, `out` needs GetCount() */
+  void ComputeMVPs(const glm::mat4& viewProjection, glm::mat4* out) const;
+
+  inline unsigned int GetCount() const { return m_Count; }
+  inline unsigned int GetCapacity() const { return m_Capacity; }
+  inline const VertexBuffer& GetInstanceBuffer() const
+  {
+    return m_InstanceBuffer;
+  }
+
+private:
+  void ComputeModel(unsigned int i);
+  void ComputeModels4(unsigned int i);
+  void ComputeModels8(unsigned int i);
+};
\ No newline at end of file
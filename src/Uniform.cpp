@@ -0,0 +1,104 @@
+#include "Uniform.h"
+
+#include <iostream>
+#include <string>
+
+#include "Assert.h"
+
+UniformTable::UniformTable()
+    : m_Slots(16, { 0, Empty })
+    , m_Count(0)
+{
+}
+
+void UniformTable::Clear()
+{
+  m_Slots.assign(16, { 0, Empty });
+  m_Count = 0;
+}
+
+void UniformTable::Build(unsigned int program)
+{
+  Clear();
+
+  int count = 0, maxLength = 0;
+  GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count));
+  GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+  std::string name(maxLength, '\0');
+  for (int i = 0; i < count; i++)
+  {
+    int length = 0, size = 0;
+    unsigned int type = 0;
+    GLCall(glGetActiveUniform(
+        program, i, maxLength, &length, &size, &type, name.data()));
+    std::string_view base(name.data(), length);
+
+    GLCall(int location = glGetUniformLocation(program, name.c_str()));
+    if (location == -1) continue; // lives in a uniform block
+
+    // arrays come back as "u_Textures[0]", register that, the bare name and
+    // every element
+    size_t bracket = base.find('[');
+    if (bracket == std::string_view::npos)
+    {
+      Insert(HashString(base), location);
+      continue;
+    }
+    base = base.substr(0, bracket);
+    Insert(HashString(base), location);
+    for (int element = 0; element < size; element++)
+    {
+      std::string elementName
+          = std::string(base) + "[" + std::to_string(element) + "]";
+      GLCall(location = glGetUniformLocation(program, elementName.c_str()));
+      Insert(HashString(elementName), location);
+    }
+  }
+}
+
+int UniformTable::Find(const Uniform& uniform)
+{
+  const unsigned int mask = (unsigned int)m_Slots.size() - 1;
+  for (unsigned int i = uniform.Hash & mask;; i = (i + 1) & mask)
+  {
+    const Slot& slot = m_Slots[i];
+    if (slot.Location == Empty) break;
+    if (slot.Hash == uniform.Hash) return slot.Location;
+  }
+
+  std::cout << "Warning: uniform '" << uniform.Name << "' doesn't exist!"
+            << std::endl;
+  Insert(uniform.Hash, -1);
+  return -1;
+}
+
+void UniformTable::Insert(uint32_t hash, int location)
+{
+  // keep it at most half full so probes stay short
+  if ((m_Count + 1) * 2 > m_Slots.size()) Grow();
+
+  const unsigned int mask = (unsigned int)m_Slots.size() - 1;
+  for (unsigned int i = hash & mask;; i = (i + 1) & mask)
+  {
+    Slot& slot = m_Slots[i];
+    if (slot.Location == Empty)
+    {
+      slot = { hash, location };
+      m_Count++;
+      return;
+    }
+    // two names with the same hash in one program, rename one of them
+    ASSERT(slot.Hash != hash || slot.Location == location);
+    if (slot.Hash == hash) return;
+  }
+}
+
+void UniformTable::Grow()
+{
+  std::vector<Slot> old(m_Slots.size() * 2, { 0, Empty });
+  old.swap(m_Slots);
+  m_Count = 0;
+  for (const Slot& slot : old)
+    if (slot.Location != Empty) Insert(slot.Hash, slot.Location);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/* FNV-1a, constexpr so uniform names written as literals hash at compile time */
+constexpr uint32_t HashString(std::string_view string)
+{
+  uint32_t hash = 2166136261u;
+  for (char c : string)
+  {
+    hash ^= (uint8_t)c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*
+ * A uniform name, already hashed. Literals convert implicitly and are hashed
+ * by the compiler, so shader.SetUniform4f("u_Color", ...) costs no string
+ * and no hashing at runtime. Runtime strings have to say so explicitly.
+ */
+struct Uniform
+{
+  uint32_t Hash;
+  const char* Name; // only for the warning, may dangle for runtime names
+
+  template <size_t N>
+  consteval Uniform(const char (&name)[N])
+      : Hash(HashString({ name, N - 1 }))
+      , Name(name)
+  {
+  }
+
+  explicit Uniform(std::string_view name)
+      : Hash(HashString(name))
+      , Name(name.data())
+  {
+  }
+};
+
+/*
+ * Open-addressed hash -> location table, filled from glGetActiveUniform
+ * right after linking. Lookups are a mask and usually one compare.
+ */
+class UniformTable
+{
+private:
+  static const int Empty = -2; // -1 is a real answer (doesn't exist)
+
+  struct Slot
+  {
+    uint32_t Hash;
+    int Location;
+  };
+  std::vector<Slot> m_Slots;
+  unsigned int m_Count;
+
+public:
+  UniformTable();
+
+  /* Throws away what's there and enumerates `program`'s active uniforms */
+  void Build(unsigned int program);
+  void Clear();
+
+  /* Location for `uniform`, or -1. Missing names are remembered (and warned
+     about) once so they don't keep showing up as misses. */
+  int Find(const Uniform& uniform);
+
+  inline unsigned int GetCount() const { return m_Count; }
+
+private:
+  void Insert(uint32_t hash, int location);
+  void Grow();
+};
\ No newline at end of file
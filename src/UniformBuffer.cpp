@@ -0,0 +1,35 @@
+#include "UniformBuffer.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, UniformBinding binding)
+    : m_Size(size)
+    , m_Binding((unsigned int)binding)
+{
+  GLCall(glGenBuffers(1, &m_RendererID));
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+  GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+  Bind();
+}
+
+UniformBuffer::~UniformBuffer()
+{
+  GLState::ForgetBuffer(m_RendererID);
+  GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::SetData(
+    const void* data, unsigned int size, unsigned int offset /*= 0 */)
+{
+  ASSERT(offset + size <= m_Size);
+  GLState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+  GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::Bind() const
+{
+  GLState::BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+}
+
+void UniformBuffer::Unbind() const
+{
+  GLState::BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, 0);
+}
\ No newline at end of file
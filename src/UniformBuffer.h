@@ -0,0 +1,134 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+#include <cstddef>
+
+#include "Assert.h"
+#include "GLState.h"
+
+/* Binding points for the blocks every shader may declare. Shader wires up a
+   block with one of these names automatically after linking. */
+enum class UniformBinding : unsigned int
+{
+  Camera = 0,
+};
+
+struct UniformBlockName
+{
+  const char* Name;
+  UniformBinding Binding;
+};
+
+inline constexpr UniformBlockName UniformBlocks[] = {
+  { "Camera", UniformBinding::Camera },
+};
+
+template <typename T> struct Std140Traits; // size and base alignment, bytes
+template <> struct Std140Traits<float>
+{
+  static constexpr unsigned int Size = 4, Align = 4;
+};
+template <> struct Std140Traits<int>
+{
+  static constexpr unsigned int Size = 4, Align = 4;
+};
+template <> struct Std140Traits<glm::vec2>
+{
+  static constexpr unsigned int Size = 8, Align = 8;
+};
+template <> struct Std140Traits<glm::vec3>
+{
+  static constexpr unsigned int Size = 12, Align = 16;
+};
+template <> struct Std140Traits<glm::vec4>
+{
+  static constexpr unsigned int Size = 16, Align = 16;
+};
+// a matrix is laid out as an array of its column vectors
+template <> struct Std140Traits<glm::mat4>
+{
+  static constexpr unsigned int Size = 64, Align = 16;
+};
+
+/*
+ * Works out std140 offsets so C++ structs can be checked against the GLSL
+ * block (see CameraBlock below). Push returns the offset of what was pushed.
+ * Arrays round every element up to a vec4, which is the rule that usually
+ * bites.
+ */
+class Std140Layout
+{
+private:
+  unsigned int m_Size;
+
+  static constexpr unsigned int RoundUp(unsigned int value, unsigned int align)
+  {
+    return (value + align - 1) / align * align;
+  }
+
+public:
+  constexpr Std140Layout()
+      : m_Size(0) {};
+
+  template <typename T> constexpr unsigned int Push(unsigned int count = 1)
+  {
+    unsigned int align = Std140Traits<T>::Align;
+    unsigned int stride = Std140Traits<T>::Size;
+    if (count > 1)
+    {
+      align = RoundUp(align, 16);
+      stride = RoundUp(stride, 16);
+    }
+    unsigned int offset = RoundUp(m_Size, align);
+    m_Size = offset + stride * count;
+    return offset;
+  }
+
+  constexpr unsigned int GetSize() const { return RoundUp(m_Size, 16); }
+};
+
+/* The Camera block, uploaded once per frame and shared by every shader:
+ *
+ *   layout(std140) uniform Camera
+ *   {
+ *       mat4 u_ViewProjection;
+ *       mat4 u_View;
+ *       mat4 u_Projection;
+ *   };
+ */
+struct CameraBlock
+{
+  glm::mat4 ViewProjection;
+  glm::mat4 View;
+  glm::mat4 Projection;
+};
+
+constexpr bool CameraBlockMatchesStd140()
+{
+  Std140Layout layout;
+  return layout.Push<glm::mat4>() == offsetof(CameraBlock, ViewProjection)
+         && layout.Push<glm::mat4>() == offsetof(CameraBlock, View)
+         && layout.Push<glm::mat4>() == offsetof(CameraBlock, Projection)
+         && layout.GetSize() == sizeof(CameraBlock);
+}
+static_assert(CameraBlockMatchesStd140(), "CameraBlock drifted from std140");
+
+class UniformBuffer
+{
+private:
+  unsigned int m_RendererID;
+  unsigned int m_Size;
+  unsigned int m_Binding;
+
+public:
+  UniformBuffer(unsigned int size, UniformBinding binding);
+  ~UniformBuffer();
+
+  void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+  /* attaches the buffer to its binding point */
+  void Bind() const;
+  void Unbind() const;
+
+  inline unsigned int GetSize() const { return m_Size; }
+};
\ No newline at end of file
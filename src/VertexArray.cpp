@@ -1,27 +1,39 @@
 #include "VertexArray.h"
 
-VertexArray::VertexArray() { GLCall(glGenVertexArrays(1, &m_RendererID)); }
+VertexArray::VertexArray()
+    : m_AttribCount(0)
+{
+  GLCall(glGenVertexArrays(1, &m_RendererID));
+}
 
-VertexArray::~VertexArray() { GLCall(glDeleteVertexArrays(1, &m_RendererID)); }
+VertexArray::~VertexArray()
+{
+  GLState::ForgetVertexArray(m_RendererID);
+  GLCall(glDeleteVertexArrays(1, &m_RendererID));
+}
 
-void VertexArray::AddBuffer(
-    const VertexBuffer& vb, const VertexBufferLayout& layout)
+void VertexArray::AddAttributes(const VertexAttribute* attributes,
+    unsigned int count, unsigned int stride, unsigned int divisor)
 {
-  Bind();
-  vb.Bind();
-  const auto& elements = layout.GetElements();
-  intptr_t offset = 0;
-  for (unsigned int i = 0; i < elements.size(); i++)
+  for (unsigned int i = 0; i < count; i++)
   {
-    const auto& element = elements[i];
-    GLCall(glEnableVertexAttribArray(i));
-
-    GLCall(glVertexAttribPointer(i, element.count, element.type,
-        element.normalized, layout.GetStride(), (const void*)offset));
+    const auto& attribute = attributes[i];
+    const unsigned int slotSize = attribute.Size / attribute.Slots;
+    for (unsigned int slot = 0; slot < attribute.Slots; slot++)
+    {
+      const unsigned int index = m_AttribCount++;
+      const intptr_t offset = attribute.Offset + slot * slotSize;
+      GLCall(glEnableVertexAttribArray(index));
 
-    offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+      GLCall(glVertexAttribPointer(index, attribute.Count, attribute.Type,
+          attribute.Normalized, stride, (const void*)offset));
+      if (divisor)
+      {
+        GLCall(glVertexAttribDivisor(index, divisor));
+      }
+    }
   }
 }
 
-void VertexArray::Bind() const { GLCall(glBindVertexArray(m_RendererID)); }
-void VertexArray::Unbind() const { GLCall(glBindVertexArray(0)); }
+void VertexArray::Bind() const { GLState::BindVertexArray(m_RendererID); }
+void VertexArray::Unbind() const { GLState::BindVertexArray(0); }
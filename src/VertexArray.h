@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Assert.h"
+#include "GLState.h"
+#include "StreamingVertexBuffer.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 
@@ -8,12 +10,41 @@ class VertexArray
 {
 private:
   unsigned int m_RendererID;
+  unsigned int m_AttribCount; // next free attribute index
 public:
   VertexArray();
   ~VertexArray();
 
-  void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+  /* Attributes continue where the previous buffer left off, so per-vertex
+     and per-instance data can live in separate buffers of one VAO. The
+     layout comes from VertexFormat<Vertex>. */
+  template <typename Vertex> void AddBuffer(const VertexBuffer& vb)
+  {
+    Bind();
+    vb.Bind();
+    AddAttributes<Vertex>();
+  }
+  /* attributes start at offset 0 of the ring, draw with a base vertex to
+     get at what Unmap() returned */
+  template <typename Vertex> void AddBuffer(const StreamingVertexBuffer& vb)
+  {
+    Bind();
+    vb.Bind();
+    AddAttributes<Vertex>();
+  }
 
   void Bind() const;
   void Unbind() const;
+
+private:
+  template <typename Vertex> void AddAttributes()
+  {
+    constexpr const auto& layout = VertexFormat<Vertex>::Layout;
+    static_assert(layout.IsValid(), "vertex layout doesn't fit its struct");
+    AddAttributes(layout.Attributes.data(), layout.Attributes.size(),
+        layout.Stride, layout.Divisor);
+  }
+  /* points the next attributes at whatever is bound to GL_ARRAY_BUFFER */
+  void AddAttributes(const VertexAttribute* attributes, unsigned int count,
+      unsigned int stride, unsigned int divisor);
 };
\ No newline at end of file
@@ -3,15 +3,33 @@
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
 {
   GLCall(glGenBuffers(1, &m_RendererID));
-  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  Bind();
   GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
-VertexBuffer::~VertexBuffer() { GLCall(glDeleteBuffers(1, &m_RendererID)); }
+VertexBuffer::VertexBuffer(unsigned int size)
+{
+  GLCall(glGenBuffers(1, &m_RendererID));
+  Bind();
+  GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
+VertexBuffer::~VertexBuffer()
+{
+  GLState::ForgetBuffer(m_RendererID);
+  GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void VertexBuffer::SetData(
+    const void* data, unsigned int size, unsigned int offset /*= 0 */)
+{
+  Bind();
+  GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
 
 void VertexBuffer::Bind() const
 {
-  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  GLState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
-void VertexBuffer::Unbind() const { GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0)); }
\ No newline at end of file
+void VertexBuffer::Unbind() const { GLState::BindBuffer(GL_ARRAY_BUFFER, 0); }
\ No newline at end of file
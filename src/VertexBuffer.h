@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Assert.h"
+#include "GLState.h"
 
 class VertexBuffer
 {
@@ -8,8 +9,12 @@ class VertexBuffer
         unsigned int m_RendererID;
     public:
         VertexBuffer(const void* data, unsigned int size);
+        /* dynamic buffer of `size` bytes, filled later through SetData */
+        VertexBuffer(unsigned int size);
         ~VertexBuffer();
 
+        void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
         void Bind() const;
         void Unbind() const;
 };
\ No newline at end of file
@@ -1,105 +1,232 @@
 #pragma once
 
-#include <vector>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/packing.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 #include "Assert.h"
 
+/*
+ * Packed attribute storage, for when a full float per component is more
+ * bandwidth than the data needs. Each one is built from the glm vector the
+ * shader ends up seeing, so filling a vertex looks the same either way:
+ *
+ *   vertex.Normal = PackedNormal(glm::vec3(0.0f, 0.0f, 1.0f));
+ *
+ * The shader still declares a vec2/vec4; GL unpacks on fetch.
+ */
+struct Half2 // 2 x GL_HALF_FLOAT, 4 bytes instead of 8
+{
+  uint32_t Bits;
+  Half2() = default;
+  Half2(const glm::vec2& v)
+      : Bits(glm::packHalf2x16(v)) {};
+};
+struct Half4 // 4 x GL_HALF_FLOAT, 8 bytes instead of 16
+{
+  uint64_t Bits;
+  Half4() = default;
+  Half4(const glm::vec4& v)
+      : Bits(glm::packHalf4x16(v)) {};
+};
+/* xyz in 10 bits each, w in 2, signed and normalized to [-1, 1] */
+struct PackedNormal // GL_INT_2_10_10_10_REV, 4 bytes instead of 12
+{
+  uint32_t Bits;
+  PackedNormal() = default;
+  PackedNormal(const glm::vec3& n, float w = 0.0f)
+      : Bits(glm::packSnorm3x10_1x2(glm::vec4(n, w))) {};
+};
+struct Snorm16x2 // 2 x GL_SHORT normalized to [-1, 1]
+{
+  uint32_t Bits;
+  Snorm16x2() = default;
+  Snorm16x2(const glm::vec2& v)
+      : Bits(glm::packSnorm2x16(v)) {};
+};
+struct Snorm16x4 // 4 x GL_SHORT normalized to [-1, 1]
+{
+  uint64_t Bits;
+  Snorm16x4() = default;
+  Snorm16x4(const glm::vec4& v)
+      : Bits(glm::packSnorm4x16(v)) {};
+};
+struct Unorm16x2 // 2 x GL_UNSIGNED_SHORT normalized to [0, 1], e.g. UVs
+{
+  uint32_t Bits;
+  Unorm16x2() = default;
+  Unorm16x2(const glm::vec2& v)
+      : Bits(glm::packUnorm2x16(v)) {};
+};
+struct Unorm8x4 // 4 x GL_UNSIGNED_BYTE normalized to [0, 1], e.g. colors
+{
+  uint32_t Bits;
+  Unorm8x4() = default;
+  Unorm8x4(const glm::vec4& v)
+      : Bits(glm::packUnorm4x8(v)) {};
+};
 
-struct VertexBufferElement
+/* How GL reads one member of a vertex struct. Slots is the number of
+   attribute locations it takes, a mat4 is one vec4 per column. */
+template <typename T> struct VertexAttributeTraits;
+template <> struct VertexAttributeTraits<float>
 {
-  unsigned int type;
-  unsigned int count;
-  unsigned char normalized;
+  static constexpr unsigned int Type = GL_FLOAT, Count = 1, Slots = 1;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<glm::vec2>
+{
+  static constexpr unsigned int Type = GL_FLOAT, Count = 2, Slots = 1;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<glm::vec3>
+{
+  static constexpr unsigned int Type = GL_FLOAT, Count = 3, Slots = 1;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<glm::vec4>
+{
+  static constexpr unsigned int Type = GL_FLOAT, Count = 4, Slots = 1;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<glm::mat4>
+{
+  static constexpr unsigned int Type = GL_FLOAT, Count = 4, Slots = 4;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<Half2>
+{
+  static constexpr unsigned int Type = GL_HALF_FLOAT, Count = 2, Slots = 1;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<Half4>
+{
+  static constexpr unsigned int Type = GL_HALF_FLOAT, Count = 4, Slots = 1;
+  static constexpr bool Normalized = false;
+};
+template <> struct VertexAttributeTraits<PackedNormal>
+{
+  static constexpr unsigned int Type = GL_INT_2_10_10_10_REV, Count = 4,
+                                Slots = 1;
+  static constexpr bool Normalized = true;
+};
+template <> struct VertexAttributeTraits<Snorm16x2>
+{
+  static constexpr unsigned int Type = GL_SHORT, Count = 2, Slots = 1;
+  static constexpr bool Normalized = true;
+};
+template <> struct VertexAttributeTraits<Snorm16x4>
+{
+  static constexpr unsigned int Type = GL_SHORT, Count = 4, Slots = 1;
+  static constexpr bool Normalized = true;
+};
+template <> struct VertexAttributeTraits<Unorm16x2>
+{
+  static constexpr unsigned int Type = GL_UNSIGNED_SHORT, Count = 2,
+                                Slots = 1;
+  static constexpr bool Normalized = true;
+};
+template <> struct VertexAttributeTraits<Unorm8x4>
+{
+  static constexpr unsigned int Type = GL_UNSIGNED_BYTE, Count = 4, Slots = 1;
+  static constexpr bool Normalized = true;
+};
 
-  static unsigned int GetSizeOfType(unsigned int type)
-  {
-    switch (type)
-    {
-      case GL_FLOAT: return 4;
-      case GL_UNSIGNED_INT: return 4;
-      case GL_UNSIGNED_BYTE: return 1;
-    }
-    ASSERT(false);
-    return 0;
-  }
+struct VertexAttribute
+{
+  unsigned int Type;
+  unsigned int Count;
+  unsigned char Normalized;
+  unsigned int Offset; // bytes from the start of the vertex
+  unsigned int Size;   // bytes, all slots together
+  unsigned int Slots;
 };
 
-class VertexBufferLayout
+template <typename T> constexpr VertexAttribute MakeVertexAttribute(
+    std::size_t offset)
 {
-private:
-  std::vector<VertexBufferElement> m_Elements;
-  unsigned int m_Stride;
+  using Traits = VertexAttributeTraits<T>;
+  return { Traits::Type, Traits::Count,
+    (unsigned char)(Traits::Normalized ? GL_TRUE : GL_FALSE),
+    (unsigned int)offset, (unsigned int)sizeof(T), Traits::Slots };
+}
 
-public:
-  VertexBufferLayout()
-      : m_Stride(0) {};
+/* one attribute per member, type deduced from the member's declaration */
+#define VERTEX_ATTRIBUTE(vertex, member)                                       \
+  MakeVertexAttribute<decltype(vertex::member)>(offsetof(vertex, member))
 
-  /*
-   * In windows world I believe static_assert(false) will only trigger if the
-   * program is compiled to call the function. I.e., if there's anywhere in the
-   * program that the function VertexBufferLayout::Push<T> is called (for which
-   * there is not a specialization). In Linux world, at least with clang (I
-   * can't speak to GCC because GCC won't acknowledge c++14 declaration that
-   * explicit specialization can be declared in any scope as below; this only
-   * compiles on clang), having this static_assert fails to compile. This is
-   * just a theory because Jesus Christ, it won't compile, but in the tutorial
-   * it does. The least I can do is add a ASSERT(false) for a runtime error.
-   *
-   * On the other hand, it may be another issue: not that there is no call to
-   * this function, but rather that the compiler interprets any call to the
-   * specializations as being calls to this function first.
-   *
-   * Idea for an experiment: a function that static_assert but is not called.
-   *
-   * Nope, verified, static_assert(false) will always prevent compilation.
-   * Crazy, that would be handy. I really want to ask either Stack Overflow or
-   * Juan about this. I could test it in Visual Studio I suppose.
-   *
-   * - Michael.
-   */
-  template <typename T> void Push(unsigned int count)
-  {
-    /* static_assert(false) */
-    ASSERT(false);
-  }
+/*
+ * Everything VertexArray needs to point GL at a buffer of Vertex, worked out
+ * at compile time. Divisor is 0 per vertex, n to advance once every n
+ * instances. Slot i of the layout goes to the first free attribute location
+ * of the VAO plus i, so members should be declared in location order.
+ */
+template <std::size_t N> struct VertexLayout
+{
+  std::array<VertexAttribute, N> Attributes;
+  unsigned int Stride;
+  unsigned int Divisor;
 
-  /* As of C++14 you can declare a template specialization in any namespace.
-   * Unfortunately, GCC ignores this fact, so we have to compile with clang++.
-   *
-   * cf: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=85282
-   *
-   * More unfortunately, VS Code's CMake/CPP extensions are somewhat bugged when
-   * selecting the clang kit, because it ends up building with /usr/bin/c++. You
-   * have to actually edit the kit file
-   * `/home/<usr>/.local/share/CMakeTools/cmake-tools-kits.json` to properly
-   * enable clang++. Even *more* unfortunately, it seems you can't prevent the
-   * editor from issuing GCC warnings here, so I just gave up and left the
-   * squiggles. Every project has problems, I guess, because the problems are
-   * bugged.
-   *
-   * - Michael.
-   */
-  template <> void Push<float>(unsigned int count)
+  constexpr unsigned int GetSlotCount() const
   {
-    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-    m_Stride += VertexBufferElement::GetSizeOfType(GL_FLOAT) * count;
+    unsigned int slots = 0;
+    for (const auto& attribute : Attributes)
+      slots += attribute.Slots;
+    return slots;
   }
 
-  template <> void Push<unsigned int>(unsigned int count)
+  /* in bounds, 4 byte aligned (some drivers fall off the fast path
+     otherwise), and within the 16 locations the spec guarantees */
+  constexpr bool IsValid() const
   {
-    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-    m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT) * count;
+    if (Stride % 4 != 0) return false;
+    for (const auto& attribute : Attributes)
+      if (attribute.Offset % 4 != 0
+          || attribute.Offset + attribute.Size > Stride)
+        return false;
+    return GetSlotCount() <= 16;
   }
+};
 
-  template <> void Push<unsigned char>(unsigned int count)
-  {
-    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-    m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE) * count;
-  }
+template <typename Vertex, typename... Attributes>
+constexpr VertexLayout<sizeof...(Attributes)> MakeVertexLayout(
+    Attributes... attributes)
+{
+  return { { attributes... }, (unsigned int)sizeof(Vertex), 0 };
+}
 
-  inline const std::vector<VertexBufferElement> GetElements() const
-  {
-    return m_Elements;
-  }
-  inline unsigned int GetStride() const { return m_Stride; }
-};
\ No newline at end of file
+template <typename Vertex, typename... Attributes>
+constexpr VertexLayout<sizeof...(Attributes)> MakeInstanceLayout(
+    Attributes... attributes)
+{
+  return { { attributes... }, (unsigned int)sizeof(Vertex), 1 };
+}
+
+/*
+ * Specialize next to the vertex struct, after it's complete:
+ *
+ *   template <> struct VertexFormat<BatchVertex>
+ *   {
+ *     static constexpr auto Layout = MakeVertexLayout<BatchVertex>(
+ *         VERTEX_ATTRIBUTE(BatchVertex, Position), ...);
+ *   };
+ *
+ * then va.AddBuffer<BatchVertex>(vb). No specialization, no compile.
+ */
+template <typename Vertex> struct VertexFormat;
+
+/* What basic.shader and instanced.shader read per vertex */
+struct TexturedVertex
+{
+  glm::vec2 Position;
+  glm::vec2 TexCoord;
+};
+
+template <> struct VertexFormat<TexturedVertex>
+{
+  static constexpr auto Layout = MakeVertexLayout<TexturedVertex>(
+      VERTEX_ATTRIBUTE(TexturedVertex, Position),
+      VERTEX_ATTRIBUTE(TexturedVertex, TexCoord));
+};
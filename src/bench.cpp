@@ -0,0 +1,1775 @@
+/*
+ * Headless benchmark harness. Every benchmark produces a named bag of
+ * metrics and the whole run is dumped as JSON so CI can diff it against the
+ * previous build.
+ *
+ *   bench [--frames N] [--sprites N] [--textures N] [--filter substr]
+ *         [--out file|-] [--trace file] [--golden dir] [--update-golden dir]
+ *
+ * Frame scenes render N frames into the offscreen target and report CPU
+ * frame time percentiles (issuing the GL calls, not waiting on the GPU) plus
+ * the average draw calls and state changes (issued and skipped by GLState)
+ * per frame from RenderStats. --trace writes every profiled frame of the run
+ * out as a Chrome trace.
+ *
+ * --golden runs only the frame scenes and checks each one's last warmup
+ * frame against dir/<name>.golden: pixels within GoldenTolerance and no more
+ * draw calls or state changes than it took then. It exits 1 if any scene
+ * doesn't match or has no golden.
+ * The frame is read back through a PixelReadback, so the timed frames don't
+ * wait on it. --update-golden writes them instead; do it on the software
+ * rasterizer CI runs on. Both always draw GoldenSprites sprites from
+ * GoldenTextures textures after GoldenWarmup frames, whatever --sprites,
+ * --textures and --frames say, so the goldens only go stale when a scene
+ * does. ctest runs the check, the update_golden target rewrites them.
+ */
+#include <GL/glew.h>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/constants.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <imgui.h>
+#include <imgui_impl_glfw_gl3.h>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Assert.h"
+#include "BatchRenderer.h"
+#include "Context.h"
+#include "DebugRenderer.h"
+#include "FrameArena.h"
+#include "GoldenImage.h"
+#include "IndexBuffer.h"
+#include "Mesh.h"
+#include "MeshImporter.h"
+#include "PixelReadback.h"
+#include "PostProcess.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "RenderCommandBuffer.h"
+#include "Renderer.h"
+#include "ResourcePack.h"
+#include "Shader.h"
+#include "ShaderCache.h"
+#include "ShaderWatcher.h"
+#include "Simulation.h"
+#include "SpatialGrid.h"
+#include "StreamingVertexBuffer.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "TextureBaker.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+#include "TransformStore.h"
+#include "UniformBuffer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+#define BASIC_SHADER "../res/shaders/basic.shader"
+#define BATCH_SHADER "../res/shaders/batch.shader"
+#define DEBUG_SHADER "../res/shaders/debug.shader"
+#define INSTANCED_SHADER "../res/shaders/instanced.shader"
+#define POST_DOWNSAMPLE_SHADER "../res/shaders/post_downsample.shader"
+#define POST_UPSAMPLE_SHADER "../res/shaders/post_upsample.shader"
+#define POST_TONEMAP_SHADER "../res/shaders/post_tonemap.shader"
+#define BASIC_TEXTURE "../res/textures/avatar.jpg"
+#define RES_ROOT "../res/"
+
+#define RES_X 960
+#define RES_Y 540
+
+using Clock = std::chrono::steady_clock;
+
+/* what the goldens are drawn with, see the top */
+static const int GoldenSprites = 1000;
+static const int GoldenTextures = 120;
+static const int GoldenWarmup = 10;
+
+struct BenchOptions
+{
+  int Frames = 300;
+  int Sprites = 10000;
+  int Textures = 120;
+  std::string Filter;
+  std::string OutPath = "bench.json"; // "-" for stdout
+  std::string TracePath;
+  std::string GoldenDir;
+  bool UpdateGolden = false;
+};
+
+struct BenchResult
+{
+  std::string Name;
+  std::vector<std::pair<std::string, double>> Metrics;
+  bool Failed = false; // only a golden check fails a run
+};
+
+static double ElapsedMs(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+/* nearest-rank percentile, `samples` must be sorted */
+static double Percentile(const std::vector<double>& samples, double p)
+{
+  if (samples.empty()) return 0.0;
+  size_t rank = (size_t)(p / 100.0 * (samples.size() - 1) + 0.5);
+  return samples[std::min(rank, samples.size() - 1)];
+}
+
+/* A scene draws one frame; the harness does the clearing and timing. */
+class Scene
+{
+public:
+  virtual ~Scene() = default;
+  /* frame counts up from a negative number during warmup */
+  virtual void Render(int frame) = 0;
+  /* anything scene specific, averaged over the `frames` measured */
+  virtual void Report(
+      std::vector<std::pair<std::string, double>>& metrics, double frames)
+  {
+  }
+};
+
+
+static glm::vec2 SpritePosition(int i, int frame)
+{
+  // spread over the screen and drift a little so nothing is static
+  return glm::vec2((float)((i * 37 + frame) % RES_X),
+      (float)((i * 91) / RES_X * 7 % RES_Y));
+}
+
+/* 8x8 textured quad: position, texture coordinate */
+// clang-format off
+static const float s_QuadVertices[] = {
+    0.0f, 0.0f, 0.0f, 0.0f,
+    8.0f, 0.0f, 1.0f, 0.0f,
+    8.0f, 8.0f, 1.0f, 1.0f,
+    0.0f, 8.0f, 0.0f, 1.0f
+};
+static const unsigned int s_QuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+// clang-format on
+
+/* The main.cpp way: one uniform upload and one draw call per sprite. */
+class PerObjectScene : public Scene
+{
+private:
+  int m_Count;
+  VertexBuffer m_VertexBuffer;
+  VertexArray m_VertexArray;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  Shader m_Shader;
+  Texture m_Texture;
+  Renderer m_Renderer;
+
+public:
+  PerObjectScene(int count)
+      : m_Count(count)
+      , m_VertexBuffer(s_QuadVertices, sizeof(s_QuadVertices))
+      , m_Shader(BASIC_SHADER)
+      , m_Texture(BASIC_TEXTURE)
+  {
+    m_VertexArray.AddBuffer<TexturedVertex>(m_VertexBuffer);
+    m_IndexBuffer = std::make_unique<IndexBuffer>(s_QuadIndices, 6);
+    m_Shader.Bind();
+    m_Shader.SetUniform1i("u_Texture", 0);
+  }
+
+  void Render(int frame) override
+  {
+    m_Texture.Bind();
+    for (int i = 0; i < m_Count; i++)
+    {
+      glm::vec2 p = SpritePosition(i, frame);
+      glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(p.x, p.y, 0));
+      m_Shader.Bind();
+      m_Shader.SetUniformMat4f("u_Model", model);
+      m_Renderer.Draw(m_VertexArray, *m_IndexBuffer, m_Shader);
+    }
+  }
+};
+
+/* Same quad, one model matrix + tint per instance, one draw call total. */
+class InstancedScene : public Scene
+{
+private:
+  using Instance = TransformInstance; // same model + tint, uploaded by hand
+
+  int m_Count;
+  std::vector<Instance> m_Instances;
+  VertexBuffer m_VertexBuffer;
+  VertexBuffer m_InstanceBuffer;
+  VertexArray m_VertexArray;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  Shader m_Shader;
+  Texture m_Texture;
+  Renderer m_Renderer;
+
+public:
+  InstancedScene(int count)
+      : m_Count(count)
+      , m_Instances(count, { glm::mat4(1.0f), glm::vec4(1.0f) })
+      , m_VertexBuffer(s_QuadVertices, sizeof(s_QuadVertices))
+      , m_InstanceBuffer(count * sizeof(Instance))
+      , m_Shader(INSTANCED_SHADER)
+      , m_Texture(BASIC_TEXTURE)
+  {
+    m_VertexArray.AddBuffer<TexturedVertex>(m_VertexBuffer);
+    m_VertexArray.AddBuffer<Instance>(m_InstanceBuffer);
+    m_IndexBuffer = std::make_unique<IndexBuffer>(s_QuadIndices, 6);
+    m_Shader.Bind();
+    m_Shader.SetUniform1i("u_Texture", 0);
+  }
+
+  void Render(int frame) override
+  {
+    for (int i = 0; i < m_Count; i++)
+    {
+      glm::vec2 p = SpritePosition(i, frame);
+      m_Instances[i].Model
+          = glm::translate(glm::mat4(1.0f), glm::vec3(p.x, p.y, 0));
+    }
+    m_InstanceBuffer.SetData(
+        m_Instances.data(), m_Count * sizeof(Instance));
+
+    m_Texture.Bind();
+    m_Renderer.DrawInstanced(
+        m_VertexArray, *m_IndexBuffer, m_Shader, m_Count);
+  }
+};
+
+class BatchScene : public Scene
+{
+private:
+  int m_Count;
+  Shader m_Shader;
+  Texture m_Texture;
+  BatchRenderer m_Batch;
+
+public:
+  BatchScene(int count)
+      : m_Count(count)
+      , m_Shader(BATCH_SHADER)
+      , m_Texture(BASIC_TEXTURE)
+      , m_Batch(m_Shader)
+  {
+  }
+
+  void Render(int frame) override
+  {
+    m_Batch.Begin();
+    for (int i = 0; i < m_Count; i++)
+      m_Batch.DrawQuad(SpritePosition(i, frame), glm::vec2(8.0f), m_Texture);
+    m_Batch.End();
+  }
+};
+
+/* Generated sprite images for the texture-switching scenes, sizes vary so
+   the packer has something to do */
+static const int s_SpriteImages = 64;
+
+static std::vector<unsigned char> SpriteImage(int i, int& width, int& height)
+{
+  width = 8 + (i * 7) % 33;
+  height = 8 + (i * 13) % 33;
+  std::vector<unsigned char> pixels((size_t)width * height * 4);
+  for (size_t p = 0; p < pixels.size(); p += 4)
+  {
+    pixels[p + 0] = (unsigned char)(i * 37);
+    pixels[p + 1] = (unsigned char)(i * 91);
+    pixels[p + 2] = (unsigned char)(p * 3);
+    pixels[p + 3] = 255;
+  }
+  return pixels;
+}
+
+/* Every sprite picks one of 64 separate textures: a flush per 15 switches */
+class ManyTexturesScene : public Scene
+{
+private:
+  int m_Count;
+  Shader m_Shader;
+  std::vector<std::unique_ptr<Texture>> m_Textures;
+  BatchRenderer m_Batch;
+
+public:
+  ManyTexturesScene(int count)
+      : m_Count(count)
+      , m_Shader(BATCH_SHADER)
+      , m_Batch(m_Shader)
+  {
+    for (int i = 0; i < s_SpriteImages; i++)
+    {
+      int width, height;
+      std::vector<unsigned char> pixels = SpriteImage(i, width, height);
+      m_Textures.push_back(
+          std::make_unique<Texture>(width, height, pixels.data()));
+    }
+  }
+
+  void Render(int frame) override
+  {
+    m_Batch.Begin();
+    for (int i = 0; i < m_Count; i++)
+      m_Batch.DrawQuad(SpritePosition(i, frame), glm::vec2(8.0f),
+          *m_Textures[i % s_SpriteImages]);
+    m_Batch.End();
+  }
+};
+
+/*
+ * Per-object draws again, but alternating between two programs and four
+ * textures, which is where draw order starts to matter. The immediate
+ * version draws in scene order; the command version records on every core
+ * and lets Renderer::Submit sort before anything is bound.
+ */
+class MixedScene : public Scene
+{
+protected:
+  int m_Count;
+  VertexBuffer m_VertexBuffer;
+  VertexArray m_VertexArray;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  std::unique_ptr<Shader> m_Shaders[2];
+  std::unique_ptr<Texture> m_Textures[4];
+  Renderer m_Renderer;
+
+public:
+  MixedScene(int count)
+      : m_Count(count)
+      , m_VertexBuffer(s_QuadVertices, sizeof(s_QuadVertices))
+  {
+    m_VertexArray.AddBuffer<TexturedVertex>(m_VertexBuffer);
+    m_IndexBuffer = std::make_unique<IndexBuffer>(s_QuadIndices, 6);
+    for (auto& shader : m_Shaders)
+    {
+      shader = std::make_unique<Shader>(BASIC_SHADER);
+      shader->Bind();
+      shader->SetUniform1i("u_Texture", 0);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+      int width, height;
+      std::vector<unsigned char> pixels = SpriteImage(i, width, height);
+      m_Textures[i] = std::make_unique<Texture>(width, height, pixels.data());
+    }
+  }
+
+  static glm::mat4 Model(int i, int frame)
+  {
+    glm::vec2 p = SpritePosition(i, frame);
+    return glm::translate(glm::mat4(1.0f), glm::vec3(p.x, p.y, 0));
+  }
+};
+
+class MixedImmediateScene : public MixedScene
+{
+public:
+  using MixedScene::MixedScene;
+
+  void Render(int frame) override
+  {
+    for (int i = 0; i < m_Count; i++)
+    {
+      Shader& shader = *m_Shaders[i % 2];
+      m_Textures[i % 4]->Bind();
+      shader.Bind();
+      shader.SetUniformMat4f("u_Model", Model(i, frame));
+      m_Renderer.Draw(m_VertexArray, *m_IndexBuffer, shader);
+    }
+  }
+};
+
+class MixedCommandScene : public MixedScene
+{
+private:
+  ThreadPool m_Pool;
+  std::vector<RenderCommandBuffer> m_Buffers;
+  std::vector<RenderCommandBuffer*> m_BufferList;
+
+public:
+  MixedCommandScene(int count, unsigned int threads = 0)
+      : MixedScene(count)
+      , m_Pool(threads)
+      , m_Buffers(m_Pool.GetThreadCount())
+  {
+    for (RenderCommandBuffer& buffer : m_Buffers)
+      m_BufferList.push_back(&buffer);
+  }
+
+  void Record(int frame)
+  {
+    for (RenderCommandBuffer& buffer : m_Buffers)
+      buffer.Reset();
+    RenderCommandBuffer::Record(m_Pool, m_Buffers, m_Count,
+        [&](RenderCommandBuffer& commands, unsigned int begin,
+            unsigned int end) {
+          for (unsigned int i = begin; i < end; i++)
+          {
+            RenderCommand& draw = commands.Draw(
+                *m_Shaders[i % 2], m_VertexArray, *m_IndexBuffer);
+            commands.SetTexture(draw, 0, *m_Textures[i % 4]);
+            commands.SetUniform(draw, "u_Model", Model(i, frame));
+          }
+        });
+  }
+
+  void Submit()
+  {
+    m_Renderer.Submit(m_BufferList.data(), m_BufferList.size());
+  }
+
+  void Render(int frame) override
+  {
+    Record(frame);
+    Submit();
+  }
+};
+
+/*
+ * How recording scales with worker count (on however many cores this box
+ * has), 100k commands per frame, best of a few. Submission is GL-thread
+ * work and doesn't change with the worker count, so it's reported once.
+ */
+static BenchResult CommandScaling(const BenchOptions& options)
+{
+  const int commands = 100000;
+  BenchResult result { "commands/scaling",
+    { { "cores", (double)std::thread::hardware_concurrency() } } };
+  for (unsigned int threads : { 1, 2, 4, 8, 16 })
+  {
+    MixedCommandScene scene(commands, threads);
+    double fastest = 1e30;
+    for (int repeat = 0; repeat < 5; repeat++)
+    {
+      Clock::time_point start = Clock::now();
+      scene.Record(repeat);
+      fastest = std::min(fastest, ElapsedMs(start));
+    }
+    result.Metrics.push_back(
+        { "record_ms_" + std::to_string(threads), fastest });
+  }
+
+  MixedCommandScene scene(options.Sprites);
+  scene.Record(0);
+  RenderStats::Reset();
+  Clock::time_point start = Clock::now();
+  scene.Submit();
+  GLCall(glFinish());
+  result.Metrics.push_back({ "submit_ms", ElapsedMs(start) });
+  result.Metrics.push_back(
+      { "submit_state_changes", (double)RenderStats::Get().StateChanges });
+  return result;
+}
+
+/*
+ * Ten times the sprites spread over a world 8x the screen each way, all of
+ * them moving. Culled, only what the grid returns for the view gets batched;
+ * unculled, everything does and the GPU clips it.
+ */
+template <bool Culled> class WorldScene : public Scene
+{
+private:
+  struct WorldSprite
+  {
+    glm::vec2 Position;
+    glm::vec2 Velocity;
+  };
+
+  std::vector<WorldSprite> m_Sprites;
+  SpatialGrid m_Grid;
+  std::vector<unsigned int> m_Visible;
+  Shader m_Shader;
+  BatchRenderer m_Batch;
+  UniformBuffer m_Camera; // the harness's is fixed, this one tours
+  double m_UpdateMs, m_QueryMs, m_Drawn, m_Tested;
+
+public:
+  WorldScene(int count)
+      : m_Sprites(count * 10)
+      , m_Grid(64.0f)
+      , m_Shader(BATCH_SHADER)
+      , m_Batch(m_Shader)
+      , m_Camera(sizeof(CameraBlock), UniformBinding::Camera)
+      , m_UpdateMs(0)
+      , m_QueryMs(0)
+      , m_Drawn(0)
+      , m_Tested(0)
+  {
+    for (unsigned int i = 0; i < m_Sprites.size(); i++)
+    {
+      m_Sprites[i] = { glm::vec2((float)(i * 7919 % (RES_X * 8)),
+                           (float)(i * 104729 % (RES_Y * 8))),
+        glm::vec2(((int)(i % 7) - 3) * 0.5f, ((int)(i % 5) - 2) * 0.5f) };
+      m_Grid.Insert(i, Box(i));
+    }
+  }
+
+  Bounds Box(unsigned int i) const
+  {
+    return { m_Sprites[i].Position, m_Sprites[i].Position + 8.0f };
+  }
+
+  void Render(int frame) override
+  {
+    Clock::time_point start = Clock::now();
+    for (unsigned int i = 0; i < m_Sprites.size(); i++)
+    {
+      // bounce off the edges like main.cpp, so the grid reaches a steady
+      // state instead of meeting new cells forever
+      WorldSprite& sprite = m_Sprites[i];
+      sprite.Position = sprite.Position + sprite.Velocity;
+      if (sprite.Position.x < 0.0f || sprite.Position.x > RES_X * 8)
+        sprite.Velocity.x = -sprite.Velocity.x;
+      if (sprite.Position.y < 0.0f || sprite.Position.y > RES_Y * 8)
+        sprite.Velocity.y = -sprite.Velocity.y;
+      if (Culled) m_Grid.Update(i, Box(i));
+    }
+    double updateMs = ElapsedMs(start);
+
+    // the camera tours the world
+    glm::vec2 camera((float)(frame * 13 % (RES_X * 7)),
+        (float)(frame * 7 % (RES_Y * 7)));
+    glm::mat4 viewProjection
+        = glm::ortho(0.0f, (float)RES_X, 0.0f, (float)RES_Y, -1.0f, 1.0f)
+          * glm::translate(glm::mat4(1.0f), glm::vec3(-camera.x, -camera.y, 0));
+    m_Visible.clear();
+    if (Culled)
+      m_Grid.Query(SpatialGrid::ViewBounds(viewProjection), m_Visible);
+
+    CameraBlock cameraData = { viewProjection, glm::mat4(1.0f),
+      viewProjection };
+    m_Camera.SetData(&cameraData, sizeof(cameraData));
+    m_Camera.Bind();
+
+    m_Batch.Begin();
+    if (Culled)
+    {
+      for (unsigned int i : m_Visible)
+        m_Batch.DrawQuad(m_Sprites[i].Position, glm::vec2(8.0f),
+            glm::vec4(1.0f, 0.5f, 0.2f, 1.0f));
+    }
+    else
+    {
+      for (const WorldSprite& sprite : m_Sprites)
+        m_Batch.DrawQuad(sprite.Position, glm::vec2(8.0f),
+            glm::vec4(1.0f, 0.5f, 0.2f, 1.0f));
+    }
+    m_Batch.End();
+
+    if (frame < 0) return;
+    m_UpdateMs += updateMs;
+    m_QueryMs += m_Grid.GetStats().QueryMs;
+    m_Drawn += Culled ? m_Visible.size() : m_Sprites.size();
+    m_Tested += m_Grid.GetStats().Candidates;
+  }
+
+  void Report(std::vector<std::pair<std::string, double>>& metrics,
+      double frames) override
+  {
+    metrics.push_back({ "sprites", (double)m_Sprites.size() });
+    metrics.push_back({ "drawn", m_Drawn / frames });
+    metrics.push_back(
+        { "cull_ratio", 1.0 - m_Drawn / frames / m_Sprites.size() });
+    metrics.push_back({ "move_ms", m_UpdateMs / frames });
+    if (!Culled) return;
+    metrics.push_back({ "query_ms", m_QueryMs / frames });
+    metrics.push_back({ "tested", m_Tested / frames });
+  }
+};
+
+/* The same images packed into one atlas page */
+class AtlasScene : public Scene
+{
+private:
+  int m_Count;
+  Shader m_Shader;
+  TextureAtlas m_Atlas;
+  std::vector<const AtlasRegion*> m_Regions;
+  BatchRenderer m_Batch;
+
+public:
+  AtlasScene(int count)
+      : m_Count(count)
+      , m_Shader(BATCH_SHADER)
+      , m_Atlas(512)
+      , m_Batch(m_Shader)
+  {
+    for (int i = 0; i < s_SpriteImages; i++)
+    {
+      int width, height;
+      std::vector<unsigned char> pixels = SpriteImage(i, width, height);
+      m_Regions.push_back(m_Atlas.Add(
+          "sprite" + std::to_string(i), width, height, pixels.data()));
+    }
+  }
+
+  void Render(int frame) override
+  {
+    m_Batch.Begin();
+    for (int i = 0; i < m_Count; i++)
+    {
+      const AtlasRegion& region = *m_Regions[i % s_SpriteImages];
+      m_Batch.DrawQuad(SpritePosition(i, frame), glm::vec2(8.0f),
+          m_Atlas.GetPage(region.Page), region.UVMin, region.UVMax);
+    }
+    m_Batch.End();
+  }
+};
+
+/* "sprite N" over every --sprites sprite, the heavy debug view */
+static std::vector<std::string> SpriteLabels(int count)
+{
+  std::vector<std::string> labels(count);
+  for (int i = 0; i < count; i++)
+    labels[i] = "sprite " + std::to_string(i);
+  return labels;
+}
+
+/* Labels through DebugRenderer: one streaming buffer, one draw call */
+class DebugLabelScene : public Scene
+{
+private:
+  std::vector<std::string> m_Labels;
+  Shader m_Shader;
+  DebugRenderer m_Debug;
+  double m_Glyphs;
+
+public:
+  DebugLabelScene(int count)
+      : m_Labels(SpriteLabels(count))
+      , m_Shader(DEBUG_SHADER)
+      , m_Debug(m_Shader)
+      , m_Glyphs(0)
+  {
+  }
+
+  void Render(int frame) override
+  {
+    const glm::mat4 proj
+        = glm::ortho(0.0f, (float)RES_X, 0.0f, (float)RES_Y, -1.0f, 1.0f);
+    m_Debug.ResetStats();
+    m_Debug.Begin(proj);
+    for (size_t i = 0; i < m_Labels.size(); i++)
+      m_Debug.DrawText(SpritePosition((int)i, frame), m_Labels[i]);
+    m_Debug.End();
+    if (frame >= 0) m_Glyphs += m_Debug.GetStats().Glyphs;
+  }
+
+  void Report(std::vector<std::pair<std::string, double>>& metrics,
+      double frames) override
+  {
+    metrics.push_back({ "glyphs", m_Glyphs / frames });
+  }
+};
+
+/*
+ * The same labels the way the game draws text today: ImGui draw lists,
+ * rebuilt and uploaded whole every frame by the GLFW/GL3 backend. No window
+ * headless, so the frame is set up by hand and only the backend's GL half
+ * is used. A draw list has 16 bit indices, hence a window per
+ * LabelsPerWindow labels.
+ */
+class ImGuiLabelScene : public Scene
+{
+public:
+  static const size_t LabelsPerWindow = 1000;
+
+private:
+  std::vector<std::string> m_Labels;
+  ImGuiContext* m_Context;
+  double m_Vertices;
+
+public:
+  ImGuiLabelScene(int count)
+      : m_Labels(SpriteLabels(count))
+      , m_Context(ImGui::CreateContext())
+      , m_Vertices(0)
+  {
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2((float)RES_X, (float)RES_Y);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui_ImplGlfwGL3_CreateDeviceObjects();
+  }
+
+  ~ImGuiLabelScene()
+  {
+    ImGui_ImplGlfwGL3_InvalidateDeviceObjects();
+    ImGui::DestroyContext(m_Context);
+    GLState::Invalidate();
+  }
+
+  void Render(int frame) override
+  {
+    ImGui::NewFrame();
+    const ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar
+                                   | ImGuiWindowFlags_NoResize
+                                   | ImGuiWindowFlags_NoInputs
+                                   | ImGuiWindowFlags_NoSavedSettings;
+    for (size_t first = 0; first < m_Labels.size(); first += LabelsPerWindow)
+    {
+      const std::string name = "labels" + std::to_string(first);
+      ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+      ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+      ImGui::SetNextWindowBgAlpha(0.0f);
+      ImGui::Begin(name.c_str(), nullptr, flags);
+      ImDrawList* list = ImGui::GetWindowDrawList();
+      const size_t last = std::min(first + LabelsPerWindow, m_Labels.size());
+      for (size_t i = first; i < last; i++)
+      {
+        // ImGui is y down
+        const glm::vec2 position = SpritePosition((int)i, frame);
+        list->AddText(ImVec2(position.x, RES_Y - position.y), 0xffffffff,
+            m_Labels[i].c_str());
+      }
+      ImGui::End();
+    }
+    ImGui::Render();
+    ImDrawData* data = ImGui::GetDrawData();
+    ImGui_ImplGlfwGL3_RenderDrawData(data);
+    GLState::Invalidate();
+
+    for (int i = 0; i < data->CmdListsCount; i++)
+      RenderStats::Get().DrawCalls += data->CmdLists[i]->CmdBuffer.Size;
+    if (frame >= 0) m_Vertices += data->TotalVtxCount;
+  }
+
+  void Report(std::vector<std::pair<std::string, double>>& metrics,
+      double frames) override
+  {
+    metrics.push_back({ "vertices", m_Vertices / frames });
+  }
+};
+
+/* BatchScene drawn through PostProcess: HDR scene, a 5 level bloom and the
+   tone map, at ScalePercent of the output resolution. After warmup the
+   pool should create nothing. */
+template <int ScalePercent> class PostScene : public Scene
+{
+private:
+  int m_Count;
+  unsigned int m_Output; // whatever the harness renders into
+  Shader m_Shader;
+  Shader m_Downsample, m_Upsample, m_Tonemap;
+  Texture m_Texture;
+  BatchRenderer m_Batch;
+  PostProcess m_Post;
+  double m_Created;
+  double m_Targets;
+  double m_Bytes;
+
+public:
+  PostScene(int count)
+      : m_Count(count)
+      , m_Output(0)
+      , m_Shader(BATCH_SHADER)
+      , m_Downsample(POST_DOWNSAMPLE_SHADER)
+      , m_Upsample(POST_UPSAMPLE_SHADER)
+      , m_Tonemap(POST_TONEMAP_SHADER)
+      , m_Texture(BASIC_TEXTURE)
+      , m_Batch(m_Shader)
+      , m_Post(RES_X, RES_Y, m_Downsample, m_Upsample, m_Tonemap)
+      , m_Created(0)
+      , m_Targets(0)
+      , m_Bytes(0)
+  {
+    GLCall(glGetIntegerv(GL_FRAMEBUFFER_BINDING, (int*)&m_Output));
+    PostProcessSettings settings;
+    settings.RenderScale = ScalePercent / 100.0f;
+    m_Post.SetSettings(settings);
+  }
+
+  void Render(int frame) override
+  {
+    m_Post.ResetStats();
+    m_Post.Begin();
+    m_Batch.Begin();
+    for (int i = 0; i < m_Count; i++)
+      m_Batch.DrawQuad(SpritePosition(i, frame), glm::vec2(8.0f), m_Texture);
+    m_Batch.End();
+    m_Post.End(m_Output);
+    if (frame < 0) return;
+    m_Created += m_Post.GetStats().Created;
+    m_Targets += m_Post.GetStats().Targets;
+    m_Bytes += (double)m_Post.GetStats().Bytes;
+  }
+
+  void Report(std::vector<std::pair<std::string, double>>& metrics,
+      double frames) override
+  {
+    metrics.push_back({ "targets", m_Targets / frames });
+    metrics.push_back({ "target_bytes", m_Bytes / frames });
+    metrics.push_back({ "targets_created", m_Created / frames });
+  }
+};
+
+/* Compares what `readback` has for the scene's golden frame against the one
+   on disk, or writes it with --update-golden. */
+static void CheckGolden(BenchResult& result, PixelReadback& readback,
+    GoldenImage& frame, const BenchOptions& options)
+{
+  ReadbackImage image;
+  if (!readback.Wait(image))
+  {
+    std::cerr << "  golden: no frame to check" << std::endl;
+    result.Failed = true;
+    return;
+  }
+  frame.Width = image.Width;
+  frame.Height = image.Height;
+  frame.Pixels = std::move(image.Pixels);
+
+  std::string file = result.Name;
+  std::replace(file.begin(), file.end(), '/', '_');
+  const std::string path = options.GoldenDir + "/" + file + ".golden";
+  if (options.UpdateGolden)
+  {
+    result.Failed = !GoldenImage::Write(path, frame);
+    std::cerr << "  golden: " << (result.Failed ? "couldn't write " : "wrote ")
+              << path << std::endl;
+    return;
+  }
+
+  GoldenImage golden;
+  if (!GoldenImage::Read(path, golden))
+  {
+    std::cerr << "  golden: FAIL, " << path
+              << " missing, build update_golden to record it" << std::endl;
+    result.Failed = true;
+    return;
+  }
+  const GoldenTolerance tolerance;
+  const GoldenDiff diff = GoldenImage::Compare(golden, frame, tolerance);
+  const double drawCallsOver = (double)frame.DrawCalls - golden.DrawCalls;
+  const double stateChangesOver
+      = (double)frame.StateChanges - golden.StateChanges;
+  const bool pixels = GoldenImage::Passes(diff, tolerance);
+  const bool cost = drawCallsOver <= tolerance.MaxDrawCallsOver
+                    && stateChangesOver <= tolerance.MaxStateChangesOver;
+  result.Failed = !pixels || !cost;
+  result.Metrics.push_back({ "golden_max_error", (double)diff.MaxError });
+  result.Metrics.push_back({ "golden_bad_fraction", diff.BadFraction });
+  result.Metrics.push_back({ "golden_rms_error", diff.RmsError });
+  result.Metrics.push_back({ "golden_draw_calls_over", drawCallsOver });
+  result.Metrics.push_back({ "golden_state_changes_over", stateChangesOver });
+  result.Metrics.push_back({ "golden_passed", result.Failed ? 0.0 : 1.0 });
+
+  if (!diff.SizeMatches)
+    std::cerr << "  golden: FAIL, " << frame.Width << "x" << frame.Height
+              << " against " << golden.Width << "x" << golden.Height
+              << std::endl;
+  else if (!pixels)
+    std::cerr << "  golden: FAIL, " << diff.BadPixels << " pixels off by more"
+              << " than " << tolerance.ChannelError << " (worst "
+              << diff.MaxError << ", rms " << diff.RmsError << ")"
+              << std::endl;
+  if (!cost)
+    std::cerr << "  golden: FAIL, " << frame.DrawCalls << " draw calls and "
+              << frame.StateChanges << " state changes, golden took "
+              << golden.DrawCalls << " and " << golden.StateChanges
+              << std::endl;
+  // cheaper than recorded passes, but the golden should follow it down
+  else if (drawCallsOver < 0 || stateChangesOver < 0)
+    std::cerr << "  golden: cheaper than recorded, update it" << std::endl;
+}
+
+static BenchResult RunScene(
+    const std::string& name, Scene& scene, const BenchOptions& options)
+{
+  Renderer renderer;
+  const glm::mat4 proj
+      = glm::ortho(0.0f, (float)RES_X, 0.0f, (float)RES_Y, -1.0f, 1.0f);
+  UniformBuffer camera(sizeof(CameraBlock), UniformBinding::Camera);
+
+  std::vector<double> cpu, total;
+  // up front, or growing them shows up in the allocation count
+  cpu.reserve(options.Frames);
+  total.reserve(options.Frames);
+  double drawCalls = 0, stateChanges = 0, skipped = 0, fenceWait = 0;
+  double allocations = 0;
+  PixelReadback readback;
+  GoldenImage golden; // the last warmup frame, what it cost and looks like
+
+  // a few frames to get shaders and buffers warm before measuring
+  const int warmup = options.GoldenDir.empty() ? std::min(10, options.Frames)
+                                              : GoldenWarmup;
+  for (int frame = -warmup; frame < options.Frames; frame++)
+  {
+    RenderStats::Reset();
+    Profiler::BeginFrame();
+    Clock::time_point start = Clock::now();
+    renderer.Clear();
+    CameraBlock cameraData = { proj, glm::mat4(1.0f), proj };
+    camera.SetData(&cameraData, sizeof(cameraData));
+    {
+      PROFILE_SCOPE("Scene");
+      PROFILE_GPU_SCOPE("Scene");
+      scene.Render(frame);
+    }
+    if (frame == -1 && !options.GoldenDir.empty())
+    {
+      // counted before the readback's own binds add to them
+      golden.DrawCalls = RenderStats::Get().DrawCalls;
+      golden.StateChanges = RenderStats::Get().StateChanges;
+      readback.Request(0, 0, RES_X, RES_Y);
+    }
+    double submitted = ElapsedMs(start);
+    {
+      PROFILE_SCOPE("Finish");
+      GLCall(glFinish()); // keep frames from piling up in the driver
+    }
+    GLCheckFrame();
+    Profiler::EndFrame();
+    FrameArena::Reset();
+    if (frame < 0) continue;
+
+    cpu.push_back(submitted);
+    total.push_back(ElapsedMs(start));
+    drawCalls += RenderStats::Get().DrawCalls;
+    stateChanges += RenderStats::Get().StateChanges;
+    skipped += RenderStats::Get().StateChangesSkipped;
+    fenceWait += RenderStats::Get().FenceWaitMs;
+    allocations += FrameArena::GetLastFrame().HeapAllocations;
+  }
+
+  std::sort(cpu.begin(), cpu.end());
+  std::sort(total.begin(), total.end());
+  const double frames = (double)cpu.size();
+  BenchResult result = { name, { { "cpu_ms_p50", Percentile(cpu, 50) },
+                     { "cpu_ms_p95", Percentile(cpu, 95) },
+                     { "cpu_ms_p99", Percentile(cpu, 99) },
+                     { "frame_ms_p50", Percentile(total, 50) },
+                     { "frame_ms_p99", Percentile(total, 99) },
+                     { "draw_calls", drawCalls / frames },
+                     { "state_changes", stateChanges / frames },
+                     { "state_changes_skipped", skipped / frames },
+                     { "fence_wait_ms", fenceWait / frames },
+                     { "allocations", allocations / frames } } };
+  scene.Report(result.Metrics, frames);
+  if (!options.GoldenDir.empty())
+    CheckGolden(result, readback, golden, options);
+  return result;
+}
+
+/*
+ * Per-call cost of a uniform lookup and of a whole SetUniformMat4f, with the
+ * old string-keyed cache (rebuilt here as it was: temporary std::string, find
+ * then operator[]) against the hashed table Shader uses now.
+ */
+static BenchResult UniformLookup(const BenchOptions&)
+{
+  const int calls = 1000000;
+  Shader shader(BASIC_SHADER);
+  shader.Bind();
+  const glm::mat4 matrix(1.0f);
+
+  std::unordered_map<std::string, int> cache;
+  auto legacyLocation = [&](const std::string& name) {
+    if (cache.find(name) != cache.end()) return cache[name];
+    int location = shader.GetUniformLocation(Uniform(name));
+    cache[name] = location;
+    return location;
+  };
+
+  auto perCallNs = [&](auto&& body) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < calls; i++)
+      body();
+    return ElapsedMs(start) * 1e6 / calls;
+  };
+
+  volatile int sink = 0;
+  double legacyLookup
+      = perCallNs([&] { sink = sink + legacyLocation("u_Model"); });
+  double hashedLookup = perCallNs(
+      [&] { sink = sink + shader.GetUniformLocation("u_Model"); });
+  double legacySet = perCallNs([&] {
+    GLCall(glUniformMatrix4fv(
+        legacyLocation("u_Model"), 1, GL_FALSE, &matrix[0][0]));
+  });
+  double hashedSet
+      = perCallNs([&] { shader.SetUniformMat4f("u_Model", matrix); });
+
+  return { "uniforms/lookup", { { "string_lookup_ns", legacyLookup },
+                                  { "hashed_lookup_ns", hashedLookup },
+                                  { "string_set_ns", legacySet },
+                                  { "hashed_set_ns", hashedSet } } };
+}
+
+/*
+ * Cold start of --textures textures: the Texture(path) constructor one after
+ * the other, against TextureLoader decoding on the pool while the main
+ * thread keeps "rendering" frames and draining the upload queue. For the
+ * async path the interesting numbers are how long the main thread is blocked
+ * (load_calls_ms, worst_frame_ms) as much as the total.
+ */
+static BenchResult TextureColdStart(const BenchOptions& options)
+{
+  const int count = options.Textures;
+
+  Clock::time_point start = Clock::now();
+  {
+    std::vector<std::unique_ptr<Texture>> textures;
+    for (int i = 0; i < count; i++)
+      textures.push_back(std::make_unique<Texture>(BASIC_TEXTURE));
+    GLCall(glFinish());
+  }
+  double serial = ElapsedMs(start);
+
+  start = Clock::now();
+  TextureLoader loader;
+  std::vector<std::shared_ptr<Texture>> textures;
+  for (int i = 0; i < count; i++)
+    textures.push_back(loader.Load(BASIC_TEXTURE));
+  double loadCalls = ElapsedMs(start);
+
+  int frames = 0;
+  double worstFrame = 0;
+  while (loader.GetPendingCount())
+  {
+    Clock::time_point frameStart = Clock::now();
+    size_t uploaded = loader.Update();
+    GLCall(glFinish());
+    worstFrame = std::max(worstFrame, ElapsedMs(frameStart));
+    frames++;
+    // a real frame would be rendering here, don't steal a core from decoding
+    if (!uploaded) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  double async = ElapsedMs(start);
+
+  return { "textures/cold_start", { { "textures", (double)count },
+                                      { "serial_ms", serial },
+                                      { "async_ms", async },
+                                      { "load_calls_ms", loadCalls },
+                                      { "worst_frame_ms", worstFrame },
+                                      { "frames_until_ready", (double)frames } } };
+}
+
+/*
+ * Loading --textures copies of the bench texture through stb_image (decode,
+ * RGBA8, no mips) against files texbake wrote in each format the driver
+ * takes, which are mapped and uploaded as is. Times are per texture, bytes
+ * are what the GPU holds per texture; the stb path also needs the decoded
+ * image on the heap for the length of the upload.
+ */
+static BenchResult TextureBaked(const BenchOptions& options)
+{
+  const int count = options.Textures;
+  auto loadAll = [&](const std::string& path, size_t& textureBytes) {
+    Clock::time_point start = Clock::now();
+    {
+      std::vector<std::unique_ptr<Texture>> textures;
+      for (int i = 0; i < count; i++)
+        textures.push_back(std::make_unique<Texture>(path));
+      GLCall(glFinish());
+      textureBytes = textures.back()->GetByteSize();
+    }
+    return ElapsedMs(start) / count;
+  };
+
+  std::vector<std::pair<std::string, double>> metrics;
+  size_t bytes = 0;
+  metrics.push_back({ "stb_ms", loadAll(BASIC_TEXTURE, bytes) });
+  metrics.push_back({ "stb_vram_bytes", (double)bytes });
+  metrics.push_back({ "stb_decode_bytes", (double)bytes });
+
+  int width, height, channels;
+  stbi_set_flip_vertically_on_load(1);
+  unsigned char* pixels
+      = stbi_load(BASIC_TEXTURE, &width, &height, &channels, 4);
+  const TextureFormat formats[] = { TextureFormat::RGBA8, TextureFormat::BC1,
+    TextureFormat::BC3, TextureFormat::ETC2 };
+  for (TextureFormat format : formats)
+  {
+    if (!pixels || !Texture::IsFormatSupported(format)) continue;
+    const std::string name = TextureFile::GetFormatName(format);
+    const std::string path = "bench_texture_" + name + ".tex";
+    Clock::time_point start = Clock::now();
+    TextureBaker::Bake(path, format, width, height, pixels);
+    metrics.push_back({ name + "_bake_ms", ElapsedMs(start) });
+    metrics.push_back({ name + "_ms", loadAll(path, bytes) });
+    metrics.push_back({ name + "_vram_bytes", (double)bytes });
+    std::remove(path.c_str());
+  }
+  if (pixels) stbi_image_free(pixels);
+  return { "textures/baked", metrics };
+}
+
+/*
+ * res/ as loose files against the same tree packed into one ResourcePack.
+ * read_*: every file opened and read through once (the pack pays for its
+ * mount there). startup_*: the shaders and the texture main.cpp loads, after
+ * a warmup so the shader cache is warm for both.
+ */
+static BenchResult ResourceStartup(const BenchOptions&)
+{
+  const char* path = "bench_res.pack";
+  ResourcePack::Write(path, RES_ROOT);
+
+  std::vector<std::string> names;
+  for (const auto& item :
+      std::filesystem::recursive_directory_iterator(RES_ROOT))
+    if (item.is_regular_file())
+      names.push_back(
+          std::filesystem::relative(item.path(), RES_ROOT).generic_string());
+
+  // something that depends on every byte, so nothing can skip the read
+  uint64_t sum = 0;
+  Clock::time_point start = Clock::now();
+  for (const std::string& name : names)
+  {
+    std::ifstream in(RES_ROOT + name, std::ios::binary | std::ios::ate);
+    std::vector<char> data((size_t)in.tellg());
+    in.seekg(0);
+    in.read(data.data(), data.size());
+    for (char c : data)
+      sum += (unsigned char)c;
+  }
+  double readLoose = ElapsedMs(start);
+
+  start = Clock::now();
+  ResourcePack pack;
+  pack.Open(path);
+  for (const std::string& name : names)
+    for (unsigned char c : pack.Find(name))
+      sum += c;
+  double readPack = ElapsedMs(start);
+
+  auto startup = [] {
+    Clock::time_point start = Clock::now();
+    {
+      Shader basic(BASIC_SHADER), batch(BATCH_SHADER),
+          instanced(INSTANCED_SHADER);
+      Texture texture(BASIC_TEXTURE);
+      GLCall(glFinish());
+    }
+    return ElapsedMs(start);
+  };
+  startup();
+  double startupLoose = startup();
+  ResourcePack::Mount(path, RES_ROOT);
+  double startupPack = startup();
+  ResourcePack::Unmount();
+  std::remove(path);
+
+  return { "resources/startup",
+    { { "files", (double)names.size() },
+        { "pack_bytes", (double)pack.GetSize() },
+        { "read_loose_ms", readLoose }, { "read_pack_ms", readPack },
+        { "startup_loose_ms", startupLoose },
+        { "startup_pack_ms", startupPack },
+        { "checksum", (double)(sum & 0xffff) } } };
+}
+
+/*
+ * The fixed-timestep thread on its own, ticking a trivial world. Throttled at
+ * 120 Hz for a second: how late ticks start after the sleep (jitter, the OS
+ * scheduler mostly). Unthrottled: how many ticks a second the loop itself
+ * manages, the ceiling for replays.
+ */
+static BenchResult SimulationTimestep(const BenchOptions&)
+{
+  uint64_t sum = 0;
+  Simulation throttled(120.0, [&](const SimulationTick& tick) {
+    sum += tick.Index;
+  });
+  throttled.Start();
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  throttled.Stop();
+  SimulationStats stats = throttled.GetStats();
+
+  Simulation unthrottled(120.0, [&](const SimulationTick& tick) {
+    sum += tick.Index;
+  });
+  unthrottled.SetUnthrottled(true);
+  Clock::time_point start = Clock::now();
+  unthrottled.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  unthrottled.Stop();
+  double seconds = ElapsedMs(start) / 1000.0;
+
+  return { "simulation/timestep",
+    { { "ticks", (double)stats.Ticks },
+        { "jitter_ms_mean", stats.MeanJitterMs },
+        { "jitter_ms_max", stats.MaxJitterMs },
+        { "ticks_dropped", (double)stats.TicksDropped },
+        { "unthrottled_ticks_per_s",
+            unthrottled.GetStats().Ticks / seconds },
+        { "checksum", (double)(sum & 0xffff) } } };
+}
+
+/*
+ * A 200x100 UV sphere written out as an OBJ with its quads in random order,
+ * about as bad as an exporter gets. ACMR as imported and after each of
+ * MeshImporter's passes (the overdraw sort gives a little of the cache win
+ * back), then loading it as the OBJ against the baked, mapped file, both
+ * all the way to the GPU.
+ */
+static BenchResult MeshOptimize(const BenchOptions&)
+{
+  const int rings = 100, segments = 200;
+  std::string obj;
+  for (int r = 0; r <= rings; r++)
+    for (int s = 0; s <= segments; s++)
+    {
+      const float theta = glm::pi<float>() * r / rings;
+      const float phi = glm::two_pi<float>() * s / segments;
+      obj += "v " + std::to_string(std::sin(theta) * std::cos(phi)) + " "
+             + std::to_string(std::cos(theta)) + " "
+             + std::to_string(std::sin(theta) * std::sin(phi)) + "\n";
+      obj += "vt " + std::to_string((float)s / segments) + " "
+             + std::to_string((float)r / rings) + "\n";
+    }
+  std::vector<std::string> faces;
+  for (int r = 0; r < rings; r++)
+    for (int s = 0; s < segments; s++)
+    {
+      const int a = r * (segments + 1) + s + 1, b = a + 1;
+      const int c = a + segments + 1, d = c + 1;
+      auto corner = [](int i) {
+        return std::to_string(i) + "/" + std::to_string(i) + " ";
+      };
+      faces.push_back("f " + corner(a) + corner(c) + corner(d) + corner(b)
+                      + "\n");
+    }
+  std::mt19937 random(1);
+  std::shuffle(faces.begin(), faces.end(), random);
+  for (const std::string& face : faces)
+    obj += face;
+
+  const char* objPath = "bench_mesh.obj";
+  const char* meshPath = "bench_mesh.mesh";
+  {
+    std::ofstream out(objPath, std::ios::binary);
+    out << obj;
+  }
+
+  MeshData mesh;
+  Clock::time_point start = Clock::now();
+  MeshImporter::ImportObj(obj, mesh);
+  double import = ElapsedMs(start);
+  const size_t vertices = mesh.Vertices.size();
+  const float imported = MeshImporter::ComputeACMR(mesh.Indices, vertices);
+
+  start = Clock::now();
+  std::vector<uint32_t> clusters
+      = MeshImporter::OptimizeVertexCache(mesh.Indices, vertices);
+  const float cache = MeshImporter::ComputeACMR(mesh.Indices, vertices);
+  MeshImporter::OptimizeOverdraw(mesh, clusters);
+  const float overdraw = MeshImporter::ComputeACMR(mesh.Indices, vertices);
+  MeshImporter::OptimizeVertexFetch(mesh);
+  double optimize = ElapsedMs(start);
+  MeshFile::Write(meshPath, mesh);
+
+  auto load = [](const char* path) {
+    Clock::time_point begin = Clock::now();
+    {
+      Mesh loaded(path);
+      GLCall(glFinish());
+    }
+    return ElapsedMs(begin);
+  };
+  double loadObj = load(objPath);
+  double loadBaked = load(meshPath);
+  std::remove(objPath);
+  std::remove(meshPath);
+
+  return { "meshes/optimize",
+    { { "vertices", (double)vertices },
+        { "triangles", (double)mesh.Indices.size() / 3 },
+        { "clusters", (double)clusters.size() },
+        { "index_bytes", (double)mesh.Indices.size()
+                             * MeshFile::GetIndexSize(vertices) },
+        { "acmr_imported", imported }, { "acmr_vertex_cache", cache },
+        { "acmr_optimized", overdraw }, { "import_ms", import },
+        { "optimize_ms", optimize }, { "load_obj_ms", loadObj },
+        { "load_baked_ms", loadBaked } } };
+}
+
+/*
+ * Packing --textures images incrementally, against loading the same atlas
+ * back from disk. Occupancy is packed pixels over page pixels.
+ */
+static BenchResult AtlasPacking(const BenchOptions& options)
+{
+  const char* path = "bench_atlas.bin";
+  double packed = 0;
+
+  Clock::time_point start = Clock::now();
+  TextureAtlas atlas(1024);
+  for (int i = 0; i < options.Textures; i++)
+  {
+    int width, height;
+    std::vector<unsigned char> pixels = SpriteImage(i, width, height);
+    if (atlas.Add("sprite" + std::to_string(i), width, height, pixels.data()))
+      packed += (double)width * height;
+  }
+  GLCall(glFinish());
+  double pack = ElapsedMs(start);
+
+  atlas.Save(path);
+  start = Clock::now();
+  TextureAtlas loaded;
+  bool ok = loaded.Load(path);
+  GLCall(glFinish());
+  double load = ElapsedMs(start);
+  std::remove(path);
+
+  return { "atlas/packing",
+    { { "images", (double)options.Textures }, { "pack_ms", pack },
+        { "load_ms", load }, { "loaded", ok ? 1.0 : 0.0 },
+        { "pages", (double)atlas.GetPageCount() },
+        { "occupancy", packed / (atlas.GetPageCount() * 1024.0 * 1024.0) } } };
+}
+
+/*
+ * Startup cost of building every shader in res/shaders: no cache, an empty
+ * (cold) cache that gets populated, and the warm cache on a second run.
+ */
+static BenchResult ShaderStartup(const BenchOptions&)
+{
+  const char* directory = "bench_shadercache";
+  const char* shaders[] = { BASIC_SHADER, BATCH_SHADER, INSTANCED_SHADER };
+  std::filesystem::remove_all(directory);
+  ShaderCache::SetDirectory(directory);
+
+  auto buildAll = [&] {
+    Clock::time_point start = Clock::now();
+    for (const char* path : shaders)
+      Shader shader(path);
+    GLCall(glFinish());
+    return ElapsedMs(start);
+  };
+
+  ShaderCache::SetEnabled(false);
+  double uncached = buildAll();
+  ShaderCache::SetEnabled(true);
+  double cold = buildAll();
+  double warm = buildAll();
+
+  std::filesystem::remove_all(directory);
+  ShaderCache::SetDirectory(".shadercache");
+  return { "shaders/startup",
+    { { "supported", ShaderCache::IsSupported() ? 1.0 : 0.0 },
+        { "uncached_ms", uncached }, { "cold_cache_ms", cold },
+        { "warm_cache_ms", warm } } };
+}
+
+/*
+ * Edits a copy of the batch shader on disk while "rendering": how long until
+ * the new program is live, the worst frame the relink cost, and that a
+ * broken edit leaves the last good program (and its sampler setup) alone.
+ */
+static BenchResult ShaderHotReload(const BenchOptions&)
+{
+  const std::string path = "bench_reload.shader";
+  std::filesystem::copy_file(BATCH_SHADER, path,
+      std::filesystem::copy_options::overwrite_existing);
+  // a changed source every run, or the binary cache hands it straight back
+  auto edit = [&](const std::string& line) {
+    std::ofstream(path, std::ios::app) << line << "\n";
+  };
+  edit("// run " + std::to_string(Clock::now().time_since_epoch().count()));
+
+  Clock::time_point start = Clock::now();
+  Shader shader(path);
+  double blockingMs = ElapsedMs(start);
+
+  int samplers[16];
+  for (int i = 0; i < 16; i++)
+    samplers[i] = i;
+  shader.Bind();
+  shader.SetUniform1iv("u_Textures", 16, samplers);
+
+  ShaderWatcher::Start();
+  // polls like a frame loop would until a reload lands, worst poll in `worst`
+  auto waitForReload = [&](double& worst) {
+    Clock::time_point edited = Clock::now();
+    while (ElapsedMs(edited) < 5000.0)
+    {
+      Clock::time_point poll = Clock::now();
+      unsigned int finished = ShaderWatcher::Poll();
+      worst = std::max(worst, ElapsedMs(poll));
+      if (finished) return ElapsedMs(edited);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return -1.0;
+  };
+
+  unsigned int original = shader.GetRendererID();
+  double worstPoll = 0.0;
+  edit("// edited");
+  double swapMs = waitForReload(worstPoll);
+  unsigned int reloaded = shader.GetRendererID();
+
+  int sampler = -1;
+  GLCall(glGetUniformiv(
+      reloaded, shader.GetUniformLocation("u_Textures[5]"), &sampler));
+
+  double brokenPoll = 0.0;
+  edit("this isn't glsl");
+  waitForReload(brokenPoll);
+  bool keptLastGood = shader.GetRendererID() == reloaded;
+
+  ShaderWatcher::Stop();
+  std::filesystem::remove(path);
+  return { "shaders/hot_reload",
+    { { "parallel_compile", GLEW_KHR_parallel_shader_compile ? 1.0 : 0.0 },
+        { "blocking_build_ms", blockingMs }, { "swap_latency_ms", swapMs },
+        { "worst_poll_ms", worstPoll },
+        { "swapped", reloaded != original ? 1.0 : 0.0 },
+        { "uniforms_kept", sampler == 5 ? 1.0 : 0.0 },
+        { "kept_last_good", keptLastGood ? 1.0 : 0.0 } } };
+}
+
+/*
+ * A few batches' worth of vertices uploaded and drawn per frame with no
+ * glFinish in between, so the GPU is still reading last frame's data while
+ * this frame's goes up: glBufferSubData into one VertexBuffer against writes
+ * into a StreamingVertexBuffer ring with a frame per region.
+ */
+static BenchResult StreamingUpload(const BenchOptions& options)
+{
+  const unsigned int chunks = 4;
+  const unsigned int vertices = BatchRenderer::MaxVertices;
+  const unsigned int bytes = vertices * sizeof(BatchVertex);
+
+  std::vector<BatchVertex> source(vertices);
+  for (unsigned int i = 0; i < vertices; i++)
+    source[i] = { SpritePosition(i / 4, 0), glm::vec2(0.0f), glm::vec4(1.0f),
+      0.0f };
+
+  Shader shader(BATCH_SHADER);
+
+  auto measure = [&](VertexArray& va, auto&& upload) {
+    std::vector<double> cpu;
+    for (int frame = 0; frame < options.Frames; frame++)
+    {
+      Clock::time_point start = Clock::now();
+      for (unsigned int chunk = 0; chunk < chunks; chunk++)
+      {
+        int first = upload();
+        shader.Bind();
+        va.Bind();
+        GLCall(glDrawArrays(GL_POINTS, first, vertices));
+      }
+      cpu.push_back(ElapsedMs(start));
+      GLCheckFrame();
+    }
+    GLCall(glFinish());
+    std::sort(cpu.begin(), cpu.end());
+    return cpu;
+  };
+
+  VertexBuffer buffer(bytes);
+  VertexArray bufferArray;
+  bufferArray.AddBuffer<BatchVertex>(buffer);
+  std::vector<double> subData = measure(bufferArray, [&] {
+    buffer.SetData(source.data(), bytes);
+    return 0;
+  });
+
+  StreamingVertexBuffer stream(chunks * bytes);
+  VertexArray streamArray;
+  streamArray.AddBuffer<BatchVertex>(stream);
+  std::vector<double> streaming = measure(streamArray, [&] {
+    void* memory = stream.Map(bytes, sizeof(BatchVertex));
+    memcpy(memory, source.data(), bytes);
+    return (int)(stream.Unmap(bytes) / sizeof(BatchVertex));
+  });
+
+  return { "streaming/upload",
+    { { "persistent", stream.IsPersistent() ? 1.0 : 0.0 },
+        { "subdata_cpu_ms_p50", Percentile(subData, 50) },
+        { "subdata_cpu_ms_p99", Percentile(subData, 99) },
+        { "ring_cpu_ms_p50", Percentile(streaming, 50) },
+        { "ring_cpu_ms_p99", Percentile(streaming, 99) },
+        { "ring_fence_wait_ms", stream.GetStats().FenceWaitMs },
+        { "ring_stalls", (double)stream.GetStats().Stalls } } };
+}
+
+/*
+ * Transform throughput on the CPU only, ns per entity, best of a few runs:
+ * translate * mat4_cast * scale per object with glm, against the SoA pass
+ * with everything dirty and with a random tenth dirty. MVPs both ways too.
+ */
+static BenchResult TransformUpdate(const BenchOptions&, unsigned int count)
+{
+  struct Object
+  {
+    glm::vec3 Position;
+    glm::quat Rotation;
+    glm::vec3 Scale;
+  };
+  std::vector<Object> objects(count);
+  std::vector<glm::mat4> models(count), mvps(count);
+  TransformStore store(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    glm::vec2 p = SpritePosition(i, 0);
+    objects[i] = { glm::vec3(p.x, p.y, 0.0f),
+      glm::angleAxis(i * 0.01f, glm::vec3(0.0f, 0.0f, 1.0f)),
+      glm::vec3(8.0f) };
+    store.Create(objects[i].Position, objects[i].Rotation, objects[i].Scale);
+  }
+  const glm::mat4 viewProjection
+      = glm::ortho(0.0f, (float)RES_X, 0.0f, (float)RES_Y, -1.0f, 1.0f);
+
+  auto best = [&](auto&& prepare, auto&& run) {
+    double fastest = 1e30;
+    for (int repeat = 0; repeat < 5; repeat++)
+    {
+      prepare();
+      Clock::time_point start = Clock::now();
+      run();
+      fastest = std::min(fastest, ElapsedMs(start));
+    }
+    return fastest * 1e6 / count;
+  };
+  auto nothing = [] {};
+  auto dirtyAll = [&] {
+    for (unsigned int i = 0; i < count; i++)
+      store.SetRotation(i, objects[i].Rotation);
+  };
+  auto dirtyTenth = [&] {
+    for (unsigned int i = 0; i < count / 10; i++)
+    {
+      unsigned int e = (i * 2654435761u) % count;
+      store.SetRotation(e, objects[e].Rotation);
+    }
+  };
+
+  double glmModels = best(nothing, [&] {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const Object& o = objects[i];
+      models[i] = glm::translate(glm::mat4(1.0f), o.Position)
+                  * glm::mat4_cast(o.Rotation)
+                  * glm::scale(glm::mat4(1.0f), o.Scale);
+    }
+  });
+  double glmMvps = best(nothing, [&] {
+    for (unsigned int i = 0; i < count; i++)
+      mvps[i] = viewProjection * models[i];
+  });
+  double soaAll = best(dirtyAll, [&] { store.UpdateTransforms(); });
+  double soaTenth = best(dirtyTenth, [&] { store.UpdateTransforms(); });
+  double soaMvps = best(nothing, [&] {
+    store.ComputeMVPs(viewProjection, mvps.data());
+  });
+
+  // both paths have to agree, or the numbers mean nothing
+  float error = 0.0f;
+  for (unsigned int i = 0; i < count; i += 997)
+    for (int c = 0; c < 4; c++)
+      for (int r = 0; r < 4; r++)
+        error = std::max(
+            error, std::abs(store.GetModel(i)[c][r] - models[i][c][r]));
+
+  return { "transforms/update_" + std::to_string(count),
+    { { "glm_model_ns", glmModels }, { "soa_model_ns", soaAll },
+        { "soa_model_tenth_dirty_ns", soaTenth }, { "glm_mvp_ns", glmMvps },
+        { "soa_mvp_ns", soaMvps }, { "max_error", error } } };
+}
+
+/*
+ * What the profiler costs: ns per CPU scope and per GPU scope (two timestamp
+ * queries), each frame as full as it gets, and how many frames had their GPU
+ * times back within Profiler::GpuLatency frames.
+ */
+static BenchResult ProfilerOverhead(const BenchOptions& options)
+{
+  const int frames = std::max(options.Frames, 100);
+  const uint64_t firstFrame = Profiler::GetRing().GetWritten();
+  const unsigned int droppedBefore = Profiler::GetGpuDropped();
+
+  auto perScope = [&](unsigned int scopes, auto&& scope) {
+    double total = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      Profiler::BeginFrame();
+      Clock::time_point start = Clock::now();
+      for (unsigned int i = 0; i < scopes; i++)
+        scope();
+      total += ElapsedMs(start);
+      Profiler::EndFrame();
+    }
+    return total * 1e6 / ((double)frames * scopes);
+  };
+  double cpu = perScope(ProfileFrame::MaxScopes, [] {
+    PROFILE_SCOPE("Empty");
+  });
+  double gpu = perScope(Profiler::MaxGpuScopes - 1, [] {
+    PROFILE_GPU_SCOPE("Empty");
+  });
+
+  const double pushed
+      = (double)(Profiler::GetRing().GetWritten() - firstFrame);
+  return { "profiler/overhead",
+    { { "cpu_scope_ns", cpu }, { "gpu_scope_ns", gpu },
+        { "gpu_frames_late",
+            (double)(Profiler::GetGpuDropped() - droppedBefore) },
+        { "frames", pushed } } };
+}
+
+struct Benchmark
+{
+  std::string Name;
+  std::function<BenchResult(const BenchOptions&)> Run;
+  bool Scene = false; // renders frames through RunScene, so it has a golden
+};
+
+template <typename T> static Benchmark FrameBenchmark(const std::string& name)
+{
+  return { name,
+    [name](const BenchOptions& options) {
+      T scene(options.Sprites);
+      return RunScene(name, scene, options);
+    },
+    true };
+}
+
+static std::vector<Benchmark> Benchmarks()
+{
+  return {
+    FrameBenchmark<PerObjectScene>("sprites/per_object"),
+    FrameBenchmark<BatchScene>("sprites/batch"),
+    FrameBenchmark<InstancedScene>("sprites/instanced"),
+    FrameBenchmark<ManyTexturesScene>("sprites/many_textures"),
+    FrameBenchmark<AtlasScene>("sprites/atlas"),
+    FrameBenchmark<MixedImmediateScene>("sprites/mixed_immediate"),
+    FrameBenchmark<MixedCommandScene>("sprites/mixed_commands"),
+    FrameBenchmark<WorldScene<false>>("world/unculled"),
+    FrameBenchmark<WorldScene<true>>("world/culled"),
+    FrameBenchmark<DebugLabelScene>("text/labels_native"),
+    FrameBenchmark<ImGuiLabelScene>("text/labels_imgui"),
+    FrameBenchmark<PostScene<100>>("post/native"),
+    FrameBenchmark<PostScene<50>>("post/half_res"),
+    { "uniforms/lookup", UniformLookup },
+    { "textures/cold_start", TextureColdStart },
+    { "textures/baked", TextureBaked },
+    { "resources/startup", ResourceStartup },
+    { "atlas/packing", AtlasPacking },
+    { "meshes/optimize", MeshOptimize },
+    { "simulation/timestep", SimulationTimestep },
+    { "shaders/startup", ShaderStartup },
+    { "shaders/hot_reload", ShaderHotReload },
+    { "streaming/upload", StreamingUpload },
+    { "profiler/overhead", ProfilerOverhead },
+    { "commands/scaling", CommandScaling },
+    { "transforms/update_10000",
+        [](const BenchOptions& o) { return TransformUpdate(o, 10000); } },
+    { "transforms/update_100000",
+        [](const BenchOptions& o) { return TransformUpdate(o, 100000); } },
+    { "transforms/update_1000000",
+        [](const BenchOptions& o) { return TransformUpdate(o, 1000000); } },
+  };
+}
+
+static void WriteJson(std::ostream& out, const BenchOptions& options,
+    const std::vector<BenchResult>& results)
+{
+  out << "{\n  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n"
+      << "  \"frames\": " << options.Frames << ",\n"
+      << "  \"sprites\": " << options.Sprites << ",\n"
+      << "  \"results\": [";
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    out << (i ? ",\n" : "\n") << "    { \"name\": \"" << results[i].Name
+        << "\"";
+    for (const auto& [key, value] : results[i].Metrics)
+      out << ", \"" << key << "\": " << value;
+    out << " }";
+  }
+  out << "\n  ]\n}" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  BenchOptions options;
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    if (!strcmp(argv[i], "--frames"))
+      options.Frames = std::stoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--sprites"))
+      options.Sprites = std::stoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--textures"))
+      options.Textures = std::stoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--filter"))
+      options.Filter = argv[i + 1];
+    else if (!strcmp(argv[i], "--out"))
+      options.OutPath = argv[i + 1];
+    else if (!strcmp(argv[i], "--trace"))
+      options.TracePath = argv[i + 1];
+    else if (!strcmp(argv[i], "--golden"))
+      options.GoldenDir = argv[i + 1];
+    else if (!strcmp(argv[i], "--update-golden"))
+    {
+      options.GoldenDir = argv[i + 1];
+      options.UpdateGolden = true;
+    }
+    else
+    {
+      std::cerr << "Unknown option " << argv[i] << std::endl;
+      return 1;
+    }
+  }
+
+  if (!options.GoldenDir.empty())
+  {
+    options.Sprites = GoldenSprites;
+    options.Textures = GoldenTextures;
+    if (options.UpdateGolden)
+      std::filesystem::create_directories(options.GoldenDir);
+  }
+
+  Context context(RES_X, RES_Y, true, false);
+  Profiler::Init();
+
+  std::vector<BenchResult> results;
+  {
+    std::unique_ptr<ProfileCapture> trace;
+    if (!options.TracePath.empty())
+      trace = std::make_unique<ProfileCapture>(options.TracePath);
+    for (const Benchmark& benchmark : Benchmarks())
+    {
+      if (benchmark.Name.find(options.Filter) == std::string::npos) continue;
+      if (!options.GoldenDir.empty() && !benchmark.Scene) continue;
+      std::cerr << "Running " << benchmark.Name << "..." << std::endl;
+      results.push_back(benchmark.Run(options));
+    }
+    Profiler::Shutdown();
+  }
+
+  if (options.OutPath == "-")
+    WriteJson(std::cout, options, results);
+  else
+  {
+    std::ofstream out(options.OutPath);
+    WriteJson(out, options, results);
+    std::cerr << "Wrote " << options.OutPath << std::endl;
+  }
+  int failed = 0;
+  for (const BenchResult& result : results)
+    if (result.Failed)
+    {
+      std::cerr << "Golden check failed: " << result.Name << std::endl;
+      failed++;
+    }
+  return failed ? 1 : 0;
+}
@@ -3,70 +3,99 @@
 #include <GLFW/glfw3.h>
 #include <GLM/glm.hpp>
 #include <GLM/gtc/matrix_transform.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include <algorithm>
+#include <charconv>
 #include <csignal>
+#include <cstring>
 #include <imgui.h>
 #include <imgui_impl_glfw_gl3.h>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include "AllocationCounter.h"
 #include "Assert.h"
+#include "BatchRenderer.h"
+#include "Context.h"
+#include "DebugRenderer.h"
+#include "FrameArena.h"
+#include "GLState.h"
 #include "IndexBuffer.h"
+#include "LatencyMeter.h"
+#include "PostProcess.h"
+#include "Profiler.h"
+#include "ProfilerPanel.h"
 #include "Renderer.h"
+#include "ResourcePack.h"
 #include "Shader.h"
+#include "ShaderWatcher.h"
+#include "Simulation.h"
+#include "SnapshotBuffer.h"
+#include "SpatialGrid.h"
 #include "Texture.h"
+#include "TransformStore.h"
+#include "UniformBuffer.h"
 #include "VertexArray.h"
 #include "VertexBuffer.h"
 
 #define BASIC_SHADER "../res/shaders/basic.shader"
+#define BATCH_SHADER "../res/shaders/batch.shader"
+#define DEBUG_SHADER "../res/shaders/debug.shader"
+#define INSTANCED_SHADER "../res/shaders/instanced.shader"
+#define POST_DOWNSAMPLE_SHADER "../res/shaders/post_downsample.shader"
+#define POST_UPSAMPLE_SHADER "../res/shaders/post_upsample.shader"
+#define POST_TONEMAP_SHADER "../res/shaders/post_tonemap.shader"
 #define BASIC_TEXTURE "../res/textures/avatar.jpg"
+#define RES_ROOT "../res/"
+#define RES_PACK "res.pack"
 
 #define RES_X 960
 #define RES_Y 540
+#define WORLD_X (RES_X * 8)
+#define WORLD_Y (RES_Y * 8)
 
-GLFWwindow* init_graphics_system()
+int main(int argc, char** argv)
 {
-  std::cout << "Starting System..." << std::endl;
-  GLFWwindow* window;
-  if (!glfwInit())
+  /* --headless renders offscreen with no vsync, --frames N stops after N,
+     --trace file writes a Chrome trace of every frame, --loose ignores
+     res.pack and reads everything from res/, --unthrottled ticks the
+     simulation as fast as it goes, --render-scale S draws the scene at S
+     times the window's resolution, --latency-probe flips the sprite count
+     every second so input-to-photon latency has an input to time */
+  bool headless = false;
+  bool loose = false;
+  bool unthrottled = false;
+  bool latencyProbe = false;
+  long frames = -1;
+  float renderScale = 1.0f;
+  std::string tracePath;
+  for (int i = 1; i < argc; i++)
   {
-    std::cout << "Failed to initialize glfw" << std::endl;
-    raise(SIGTRAP);
+    if (!strcmp(argv[i], "--headless"))
+      headless = true;
+    else if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+      frames = std::stol(argv[++i]);
+    else if (!strcmp(argv[i], "--trace") && i + 1 < argc)
+      tracePath = argv[++i];
+    else if (!strcmp(argv[i], "--loose"))
+      loose = true;
+    else if (!strcmp(argv[i], "--unthrottled"))
+      unthrottled = true;
+    else if (!strcmp(argv[i], "--latency-probe"))
+      latencyProbe = true;
+    else if (!strcmp(argv[i], "--render-scale") && i + 1 < argc)
+      renderScale = std::stof(argv[++i]);
   }
+  if (headless && frames < 0) frames = 600;
+  if (!loose) ResourcePack::Mount(RES_PACK, RES_ROOT);
 
-  /* specify ogl profile */
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-  window = glfwCreateWindow(RES_X, RES_Y, "OpenGL", nullptr, nullptr);
-  if (!window)
-  {
-    glfwTerminate();
-    std::cout << "Opening window failed." << std::endl;
-    raise(SIGTRAP);
-  }
-
-  glfwMakeContextCurrent(window);
-  glfwSwapInterval(1);
-
-  if (glewInit() != GLEW_OK)
-  {
-    std::cout << "glewInit failed" << std::endl;
-    raise(SIGTRAP);
-  }
-
-  std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-
-  // Enable blending for transparency
-  GLCall(glEnable(GL_BLEND));
-  GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-
-  std::cout << "Initialization complete..." << std::endl;
-  return window;
-}
-
-int main()
-{
-  GLFWwindow* window = init_graphics_system();
+  Context context(RES_X, RES_Y, headless, !headless);
+  Profiler::Init();
+  std::unique_ptr<ProfileCapture> trace;
+  if (!tracePath.empty()) trace = std::make_unique<ProfileCapture>(tracePath);
+  GLFWwindow* window = context.GetWindow();
   /* vertices of the triangle */
   // clang-format off
   float positions[] = {
@@ -84,16 +113,15 @@ int main()
   VertexBuffer vb(positions, 4 * 4 * sizeof(float));
 
   VertexArray va;
-  VertexBufferLayout layout;
-  layout.Push<float>(2);
-  layout.Push<float>(2);
-  va.AddBuffer(vb, layout);
+  va.AddBuffer<TexturedVertex>(vb);
   IndexBuffer ib(indices, 6);
 
   // normalized projection against the screen
   glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
-  // camera shifted right 100 px
-  glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-100, 0, 0));
+  // camera starts shifted right 100 px, the slider pans it over the world
+  glm::vec2 cameraPosition(100.0f, 0.0f);
+  // shared by every shader through the Camera block
+  UniformBuffer camera(sizeof(CameraBlock), UniformBinding::Camera);
 
   Shader shader(BASIC_SHADER);
   shader.Bind();
@@ -110,56 +138,381 @@ int main()
   shader.Unbind();
 
   Renderer renderer;
-  ImGui::CreateContext();
-  ImGui_ImplGlfwGL3_Init(window, true);
-  ImGui::StyleColorsDark();
+  Shader batchShader(BATCH_SHADER);
+  BatchRenderer batch(batchShader);
+  Shader debugShader(DEBUG_SHADER);
+  DebugRenderer debug(debugShader);
+  bool labels = !window; // headless, so they get exercised
+  Shader downsampleShader(POST_DOWNSAMPLE_SHADER);
+  Shader upsampleShader(POST_UPSAMPLE_SHADER);
+  Shader tonemapShader(POST_TONEMAP_SHADER);
+  PostProcess post(
+      RES_X, RES_Y, downsampleShader, upsampleShader, tonemapShader);
+  PostProcessSettings postSettings;
+  postSettings.RenderScale = renderScale;
+  post.SetSettings(postSettings);
+  int spriteCount = 1000;
+
+  /* sprites drifting around a world 8x the screen each way, only the ones
+     the grid says are on screen get batched */
+  struct WorldSprite
+  {
+    glm::vec2 Position;
+    glm::vec2 Velocity;
+  };
+  const int maxSprites = 100000;
+  std::vector<WorldSprite> sprites(maxSprites);
+  for (int i = 0; i < maxSprites; i++)
+    sprites[i] = { glm::vec2((float)(i * 7919u % WORLD_X),
+                       (float)(i * 104729u % WORLD_Y)),
+      glm::vec2((i % 7 - 3) * 0.5f, (i % 5 - 2) * 0.5f) };
+  // where they're drawn this frame, in between two ticks
+  std::vector<glm::vec2> drawPositions(maxSprites);
+  auto spriteBounds = [&](int i) {
+    return Bounds { drawPositions[i], drawPositions[i] + 5.0f };
+  };
+  SpatialGrid world(64.0f);
+  int worldCount = 0; // how many of `drawPositions` are in the grid
+  std::vector<unsigned int> visible;
+
+  /* The color pulse, the swarm's spin and the sprites' drift tick at 60 Hz
+     on their own thread, whatever the display does. The frame loop sends
+     input one way and gets snapshots back the other, neither waits. */
+  struct WorldInput
+  {
+    int SpriteCount = 0;
+    uint64_t Sequence = 0; // bumped on every change
+    Simulation::Clock::time_point Time;
+  };
+  struct WorldState
+  {
+    float Red = 0.0f;
+    float Spin = 0.0f;
+    std::vector<glm::vec2> Positions; // the first SpriteCount sprites
+    uint64_t InputSequence = 0;       // newest input this state has seen
+    Simulation::Clock::time_point InputTime;
+  };
+  struct WorldSnapshot
+  {
+    WorldState Previous, Current;
+    Simulation::Clock::time_point Due;
+  };
+  SnapshotBuffer<WorldInput> worldInput;
+  SnapshotBuffer<WorldSnapshot> worldSnapshots;
+  // reserved up front, ticking never allocates
+  worldSnapshots.ForEach([&](WorldSnapshot& snapshot) {
+    snapshot.Previous.Positions.reserve(maxSprites);
+    snapshot.Current.Positions.reserve(maxSprites);
+  });
+  WorldState worldState; // the simulation's own, copied into each snapshot
+  worldState.Positions.reserve(maxSprites);
+  float increment = 0.05f;
+
+  Simulation simulation(60.0, [&](const SimulationTick& tick) {
+    worldInput.Acquire();
+    const WorldInput& input = worldInput.GetFront();
+    WorldSnapshot& snapshot = worldSnapshots.GetBack();
+    snapshot.Previous = worldState;
+
+    /* increment/decrement the red value for the uniform */
+    if (worldState.Red > 1.0f)
+      increment = -0.05f;
+    else if (worldState.Red < 0.0f)
+      increment = 0.05f;
+    worldState.Red += increment;
+    worldState.Spin += 0.05f;
+
+    worldState.Positions.resize(input.SpriteCount);
+    for (int i = 0; i < input.SpriteCount; i++)
+    {
+      WorldSprite& sprite = sprites[i];
+      sprite.Position = sprite.Position + sprite.Velocity;
+      if (sprite.Position.x < 0.0f || sprite.Position.x > WORLD_X)
+        sprite.Velocity.x = -sprite.Velocity.x;
+      if (sprite.Position.y < 0.0f || sprite.Position.y > WORLD_Y)
+        sprite.Velocity.y = -sprite.Velocity.y;
+      worldState.Positions[i] = sprite.Position;
+    }
+    worldState.InputSequence = input.Sequence;
+    worldState.InputTime = input.Time;
+
+    snapshot.Current = worldState;
+    snapshot.Due = tick.Due;
+    worldSnapshots.Publish();
+  });
+
+  /* a swarm of spinning quads, transforms rebuilt in bulk, one draw */
+  // clang-format off
+  float unitQuad[] = {
+      -0.5f, -0.5f, 0.0f, 0.0f,
+       0.5f, -0.5f, 1.0f, 0.0f,
+       0.5f,  0.5f, 1.0f, 1.0f,
+      -0.5f,  0.5f, 0.0f, 1.0f
+  };
+  // clang-format on
+  VertexBuffer swarmVertices(unitQuad, sizeof(unitQuad));
+  TransformStore swarm(10000);
+  for (unsigned int i = 0; i < swarm.GetCapacity(); i++)
+    swarm.Create(glm::vec3(10.0f + (i % 160) * 6.0f, 10.0f + (i / 160) * 6.0f,
+                     0.0f),
+        glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(4.0f),
+        glm::vec4((i % 160) / 160.0f, 0.8f, (i / 160) / 64.0f, 1.0f));
+  VertexArray swarmArray;
+  swarmArray.AddBuffer<TexturedVertex>(swarmVertices);
+  swarmArray.AddBuffer<TransformInstance>(swarm.GetInstanceBuffer());
+  Shader swarmShader(INSTANCED_SHADER);
+  swarmShader.Bind();
+  swarmShader.SetUniform1i("u_Texture", 0);
+  int swarmCount = 0;
+  std::unique_ptr<ProfilerPanel> profilerPanel;
+  if (window)
+  {
+    // save a .shader file and it relinks in place
+    ShaderWatcher::Start();
+    ImGui::CreateContext();
+    ImGui_ImplGlfwGL3_Init(window, true);
+    ImGui::StyleColorsDark();
+    profilerPanel = std::make_unique<ProfilerPanel>();
+  }
   glm::vec3 translation(200, 200, 0);
   //bool show_demo_window = true;
   //bool show_another_window = false;
   //ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
-  /* for my uniform */
-  float r = 0.0f;
-  float increment = 0.05f;
+  WorldInput input = { spriteCount, 0, Simulation::Clock::now() };
+  worldInput.GetBack() = input;
+  worldInput.Publish();
+  simulation.SetUnthrottled(unthrottled);
+  simulation.Start();
+  LatencyMeter latency;
+  uint64_t presentedInput = 0; // newest input a swapped frame has shown
+
+  // heap allocations once things have settled, should stay at zero
+  const long warmupFrames = 60;
+  uint64_t steadyAllocations = 0;
+  long steadyFrames = 0;
 
   std::cout << "Starting loop..." << std::endl;
-  while (!glfwWindowShouldClose(window))
+  for (long frame = 0; frame != frames && !context.ShouldClose(); frame++)
   {
+    Profiler::BeginFrame();
+    RenderStats::Reset();
+    ShaderWatcher::Poll();
+    latency.Poll();
+    // the frame draws into the HDR scene target, End() puts it on screen
+    post.ResetStats();
+    post.Begin();
 
-    renderer.Clear();
+    /* newest world state, blended toward from the one before it */
+    worldSnapshots.Acquire();
+    const WorldSnapshot& snapshot = worldSnapshots.GetFront();
+    const float alpha = (float)simulation.GetAlpha(
+        snapshot.Due, Simulation::Clock::now());
+    const WorldState& previous = snapshot.Previous;
+    const WorldState& current = snapshot.Current;
 
-    ImGui_ImplGlfwGL3_NewFrame();
+    if (window) ImGui_ImplGlfwGL3_NewFrame();
+
+    /* camera goes up once, every shader reads the same block */
+    glm::mat4 view = glm::translate(
+        glm::mat4(1.0f), glm::vec3(-cameraPosition.x, -cameraPosition.y, 0));
+    CameraBlock cameraData = { proj * view, view, proj };
+    camera.SetData(&cameraData, sizeof(cameraData));
 
     // model moved up and left 200 px at the perspective
     glm::mat4 model = glm::translate(glm::mat4(1.0f), translation);
-    glm::mat4 mvp = proj * view * model;
 
     shader.Bind();
-    shader.SetUniform4f("u_Color", r, 0.3f, 0.8f, 1.0f);
-    shader.SetUniformMat4f("u_MVP", mvp);
+    shader.SetUniform4f("u_Color", glm::mix(previous.Red, current.Red, alpha),
+        0.3f, 0.8f, 1.0f);
+    shader.SetUniformMat4f("u_Model", model);
 
     renderer.Draw(va, ib, shader);
 
-    /* increment/decrement the red value for the uniform */
-    if (r > 1.0f)
-      increment = -0.05f;
-    else if (r < 0.0f)
-      increment = 0.05f;
-    r += increment;
+    /* the grid follows whatever the simulation has, moved in between */
+    {
+      PROFILE_SCOPE("Move sprites");
+      const int count = (int)current.Positions.size();
+      const int blended = std::min(count, (int)previous.Positions.size());
+      for (int i = 0; i < blended; i++)
+        drawPositions[i]
+            = glm::mix(previous.Positions[i], current.Positions[i], alpha);
+      for (int i = blended; i < count; i++)
+        drawPositions[i] = current.Positions[i];
+      for (; worldCount < count; worldCount++)
+        world.Insert(worldCount, spriteBounds(worldCount));
+      for (; worldCount > count; worldCount--)
+        world.Remove(worldCount - 1);
+      for (int i = 0; i < worldCount; i++)
+        world.Update(i, spriteBounds(i));
+    }
+
+    /* every other one textured, in as few draws as fit */
+    {
+      PROFILE_SCOPE("Sprites");
+      PROFILE_GPU_SCOPE("Sprites");
+      visible.clear();
+      world.Query(SpatialGrid::ViewBounds(proj * view), visible);
+      batch.ResetStats();
+      batch.Begin();
+      for (unsigned int i : visible)
+      {
+        if (i % 2)
+          batch.DrawQuad(drawPositions[i], glm::vec2(5.0f), texture);
+        else
+          batch.DrawQuad(drawPositions[i], glm::vec2(5.0f),
+              glm::vec4((i % 100) / 100.0f, 0.3f, 0.8f, 1.0f));
+      }
+      batch.End();
+    }
+
+    {
+      PROFILE_SCOPE("Swarm");
+      PROFILE_GPU_SCOPE("Swarm");
+      const float spin = glm::mix(previous.Spin, current.Spin, alpha);
+      for (int i = 0; i < swarmCount; i++)
+        swarm.SetRotation(i, glm::angleAxis(spin + i * 0.01f,
+                                 glm::vec3(0.0f, 0.0f, 1.0f)));
+      swarm.Update();
+      texture.Bind();
+      renderer.DrawInstanced(swarmArray, ib, swarmShader, swarmCount);
+    }
+
+    /* numbers over the sprites that made it through culling */
     {
+      PROFILE_SCOPE("Debug");
+      PROFILE_GPU_SCOPE("Debug");
+      debug.ResetStats();
+      debug.Begin(proj * view);
+      debug.DrawRect(glm::vec2(0.0f), glm::vec2(WORLD_X, WORLD_Y),
+          glm::vec4(1.0f, 0.3f, 0.3f, 1.0f), 2.0f);
+      if (labels)
+      {
+        char label[16];
+        for (unsigned int i : visible)
+        {
+          const char* end = std::to_chars(label, label + sizeof(label), i).ptr;
+          debug.DrawText(drawPositions[i] + glm::vec2(0.0f, 14.0f),
+              std::string_view(label, end - label));
+        }
+      }
+      debug.End();
+    }
+
+    {
+      PROFILE_SCOPE("Post");
+      PROFILE_GPU_SCOPE("Post");
+      post.End(context.GetFramebuffer());
+    }
+
+    // stands in for someone on the slider, headless there's nobody
+    if (latencyProbe && frame % 60 == 0)
+      spriteCount = 1000 + frame / 60 % 2 * 100;
+    if (window)
+    {
+      PROFILE_SCOPE("ImGui");
+      PROFILE_GPU_SCOPE("ImGui");
       ImGui::SliderFloat3("Translation", &translation.x, 0.0f, 960.0f);
+      ImGui::SliderInt("Sprites", &spriteCount, 0, maxSprites);
+      ImGui::SliderFloat2("Camera", &cameraPosition.x, 0.0f,
+          (float)std::max(WORLD_X - RES_X, WORLD_Y - RES_Y));
+      const CullStats& cull = world.GetStats();
+      ImGui::Text("Culling: %u of %u drawn (%.1f%% culled), %u tested in "
+                  "%.3f ms",
+          cull.Visible, cull.Items,
+          cull.Items ? 100.0f * (cull.Items - cull.Visible) / cull.Items : 0.0f,
+          cull.Candidates, cull.QueryMs);
+      ImGui::Checkbox("Labels", &labels);
+      ImGui::SameLine();
+      ImGui::Text("Debug: %u glyphs, %u shapes in %u draw calls",
+          debug.GetStats().Glyphs, debug.GetStats().Shapes,
+          debug.GetStats().DrawCalls);
+      ImGui::SliderInt("Entities", &swarmCount, 0, swarm.GetCapacity());
+      PostProcessSettings settings = post.GetSettings();
+      ImGui::SliderFloat("Render scale", &settings.RenderScale, 0.25f, 2.0f);
+      ImGui::SliderFloat("Exposure", &settings.Exposure, 0.1f, 4.0f);
+      ImGui::Checkbox("Bloom", &settings.Bloom);
+      ImGui::SameLine();
+      ImGui::SliderFloat("Threshold", &settings.BloomThreshold, 0.0f, 2.0f);
+      ImGui::SliderFloat("Intensity", &settings.BloomIntensity, 0.0f, 2.0f);
+      post.SetSettings(settings);
+      ImGui::Text("Post: %dx%d scene, %u targets (%zu KB), %u created",
+          post.GetSceneWidth(), post.GetSceneHeight(), post.GetStats().Targets,
+          post.GetStats().Bytes / 1024, post.GetStats().Created);
+      ImGui::Text("Batch: %u quads in %u draw calls",
+          batch.GetStats().QuadCount, batch.GetStats().DrawCalls);
+      ImGui::Text("Frame: %u draw calls, %u state changes (%u skipped)",
+          RenderStats::Get().DrawCalls, RenderStats::Get().StateChanges,
+          RenderStats::Get().StateChangesSkipped);
+      ImGui::Text("Streaming: %.2f ms waiting on fences, %u stalls",
+          RenderStats::Get().FenceWaitMs, batch.GetStreamingStats().Stalls);
+      if (AllocationCounter::IsCounting())
+        ImGui::Text("Memory: %llu heap allocations last frame (%llu bytes), "
+                    "%zu KB of frame arena",
+            (unsigned long long)FrameArena::GetLastFrame().HeapAllocations,
+            (unsigned long long)FrameArena::GetLastFrame().HeapBytes,
+            FrameArena::GetLastFrame().ArenaBytes / 1024);
+      const SimulationStats& tick = simulation.GetStats();
+      ImGui::Text("Simulation: %llu ticks, %.3f ms late on average "
+                  "(worst %.3f), %.1f ms input to photon",
+          (unsigned long long)tick.Ticks, tick.MeanJitterMs, tick.MaxJitterMs,
+          latency.GetStats().LastMs);
       ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
           1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+      profilerPanel->Draw();
+
+      ImGui::Render();
+      ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
+      // ImGui restores what it touches, but it doesn't tell us about it
+      GLState::Invalidate();
+    }
+
+    // the slider was read just now, the simulation picks it up next tick
+    if (spriteCount != input.SpriteCount)
+    {
+      input = { spriteCount, input.Sequence + 1, Simulation::Clock::now() };
+      worldInput.GetBack() = input;
+      worldInput.Publish();
     }
 
-    ImGui::Render();
-    ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    {
+      PROFILE_SCOPE("Swap");
+      context.SwapBuffers();
+    }
+    // first frame to show an input, it's on its way to the screen
+    if (current.InputSequence != presentedInput)
+    {
+      latency.Present(current.InputTime);
+      presentedInput = current.InputSequence;
+    }
+    Profiler::EndFrame();
+    FrameArena::Reset();
+    if (frame >= warmupFrames)
+    {
+      steadyAllocations += FrameArena::GetLastFrame().HeapAllocations;
+      steadyFrames++;
+    }
   }
 
+  if (steadyFrames && AllocationCounter::IsCounting())
+    std::cout << "Heap allocations per frame after warmup: "
+              << (double)steadyAllocations / steadyFrames << std::endl;
+  simulation.Stop();
+  const SimulationStats& tick = simulation.GetStats();
+  std::cout << "Simulation: " << tick.Ticks << " ticks, " << tick.MeanJitterMs
+            << " ms mean jitter, " << tick.MaxJitterMs << " ms worst, "
+            << tick.TicksDropped << " dropped" << std::endl;
+  if (latency.GetStats().Samples)
+    std::cout << "Input to photon: " << latency.GetStats().MeanMs
+              << " ms mean, " << latency.GetStats().MaxMs << " ms worst"
+              << std::endl;
   std::cout << "Exiting..." << std::endl;
-  ImGui_ImplGlfwGL3_Shutdown();
-  ImGui::DestroyContext();
-  glfwTerminate();
+  ShaderWatcher::Stop();
+  Profiler::Shutdown();
+  trace.reset(); // after Shutdown, which pushes the last few frames
+  if (window)
+  {
+    ImGui_ImplGlfwGL3_Shutdown();
+    ImGui::DestroyContext();
+  }
   return 0;
 }
@@ -0,0 +1,44 @@
+/*
+ * respack: bundles every file under a directory into one ResourcePack.
+ *
+ *   respack <directory> <output>
+ *
+ * The build runs it over res/ into res.pack next to the binaries, which
+ * main mounts in place of the loose files when it's there.
+ */
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "ResourcePack.h"
+
+int main(int argc, char** argv)
+{
+  if (argc != 3)
+  {
+    std::cerr << "usage: respack <directory> <output>" << std::endl;
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  if (!ResourcePack::Write(argv[2], argv[1]))
+  {
+    std::cerr << "Can't pack " << argv[1] << " into " << argv[2]
+              << std::endl;
+    return 1;
+  }
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start)
+                  .count();
+
+  ResourcePack pack;
+  if (!pack.Open(argv[2]) || !pack.Verify())
+  {
+    std::cerr << argv[2] << " doesn't read back" << std::endl;
+    return 1;
+  }
+  std::cerr << argv[1] << " -> " << argv[2] << ": " << pack.GetEntryCount()
+            << " files, " << pack.GetSize() << " bytes, " << ms << " ms"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * texbake: converts an image stb_image can read into the container
+ * TextureFile maps at runtime, mip chain included.
+ *
+ *   texbake [--format auto|rgba8|bc1|bc3|etc2] [--no-mips] in.png out.tex
+ *
+ * auto is BC1 for opaque images and BC3 when there's any alpha. ETC2 is for
+ * drivers without S3TC (GL 4.3 or ES 3 compatibility has it).
+ */
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "TextureBaker.h"
+#include "TextureFile.h"
+#include "stb_image/stb_image.h"
+
+static void Usage()
+{
+  std::cerr << "usage: texbake [--format auto|rgba8|bc1|bc3|etc2] "
+               "[--no-mips] <input> <output>"
+            << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  std::string format = "auto";
+  bool mipmaps = true;
+  std::string paths[2];
+  int pathCount = 0;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--format") && i + 1 < argc)
+      format = argv[++i];
+    else if (!strcmp(argv[i], "--no-mips"))
+      mipmaps = false;
+    else if (argv[i][0] != '-' && pathCount < 2)
+      paths[pathCount++] = argv[i];
+    else
+    {
+      Usage();
+      return 1;
+    }
+  }
+  if (pathCount != 2)
+  {
+    Usage();
+    return 1;
+  }
+
+  int width, height, channels;
+  stbi_set_flip_vertically_on_load(1); // same orientation Texture loads
+  unsigned char* pixels
+      = stbi_load(paths[0].c_str(), &width, &height, &channels, 4);
+  if (!pixels)
+  {
+    std::cerr << "Can't read " << paths[0] << ": " << stbi_failure_reason()
+              << std::endl;
+    return 1;
+  }
+
+  TextureFormat textureFormat;
+  if (format == "auto")
+    textureFormat = TextureBaker::HasAlpha(width, height, pixels)
+                        ? TextureFormat::BC3
+                        : TextureFormat::BC1;
+  else if (format == "rgba8")
+    textureFormat = TextureFormat::RGBA8;
+  else if (format == "bc1")
+    textureFormat = TextureFormat::BC1;
+  else if (format == "bc3")
+    textureFormat = TextureFormat::BC3;
+  else if (format == "etc2")
+    textureFormat = TextureFormat::ETC2;
+  else
+  {
+    stbi_image_free(pixels);
+    Usage();
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  bool ok = TextureBaker::Bake(
+      paths[1], textureFormat, width, height, pixels, mipmaps);
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start)
+                  .count();
+  stbi_image_free(pixels);
+  if (!ok)
+  {
+    std::cerr << "Can't write " << paths[1] << std::endl;
+    return 1;
+  }
+
+  TextureFile baked;
+  baked.Open(paths[1]);
+  size_t bytes = 0;
+  for (unsigned int i = 0; i < baked.GetLevelCount(); i++)
+    bytes += baked.GetLevel(i).Size;
+  std::cerr << paths[0] << " -> " << paths[1] << ": " << width << "x"
+            << height << " " << TextureFile::GetFormatName(textureFormat)
+            << ", " << baked.GetLevelCount() << " levels, " << bytes
+            << " bytes (" << (size_t)width * height * 4 << " as RGBA8), "
+            << ms << " ms" << std::endl;
+  return 0;
+}